@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * The allocations made by the current thread while an allocation_counter was
+ * running. peak_live_bytes is how far the live heap grew above where it was
+ * when the counter started; since benchmark iterations free what they
+ * allocate, it is the peak memory use of a single iteration.
+ */
+struct allocation_counts {
+  size_t allocations = 0;
+  size_t bytes_allocated = 0;
+  size_t peak_live_bytes = 0;
+};
+
+/**
+ * The counts of the current thread, maintained by the malloc replacement in
+ * allocation_counters.cpp while running_counters is not zero. live_bytes is
+ * signed because a thread can free memory that another thread allocated, or
+ * that it allocated before it started counting.
+ */
+struct thread_allocation_state {
+  size_t allocations;
+  size_t bytes_allocated;
+  int64_t live_bytes;
+  int64_t peak_live_bytes;
+  size_t running_counters;
+};
+
+thread_allocation_state &thread_allocations();
+void start_counting_allocations();
+void stop_counting_allocations();
+bool allocation_counting_available();
+
+/**
+ * Counts the heap allocations of the current thread between construction and
+ * stop(). The benchmark executable replaces malloc, calloc, realloc and the
+ * aligned allocation functions with versions that count before forwarding to
+ * the C library, which covers operator new as well. That is only possible with
+ * glibc and without sanitizers, which bring their own allocator; elsewhere,
+ * available() is false and all counts are zero. Allocations are only counted
+ * while an allocation_counter exists, so that the replacement functions do not
+ * slow down the rest of the program.
+ */
+class allocation_counter final {
+ public:
+  static bool available() {
+    return allocation_counting_available();
+  }
+
+  /**
+   * Whether the benchmarks should count their allocations, which is requested
+   * with the SPOTIFY_JSON_BENCHMARK_ALLOCATIONS environment variable since
+   * counting adds to the time of every allocation.
+   */
+  static bool requested() {
+    const auto value = std::getenv("SPOTIFY_JSON_BENCHMARK_ALLOCATIONS");
+    return available() && value && *value && std::strcmp(value, "0") != 0;
+  }
+
+  allocation_counter()
+      : _start(start()) {}
+
+  allocation_counter(const allocation_counter &) = delete;
+  allocation_counter &operator=(const allocation_counter &) = delete;
+
+  ~allocation_counter() {
+    stop_counting_allocations();
+  }
+
+  allocation_counts stop() const {
+    const auto &state = thread_allocations();
+    allocation_counts counts;
+    counts.allocations = state.allocations - _start.allocations;
+    counts.bytes_allocated = state.bytes_allocated - _start.bytes_allocated;
+    counts.peak_live_bytes = size_t(state.peak_live_bytes - _start.live_bytes);
+    return counts;
+  }
+
+ private:
+  static thread_allocation_state start() {
+    start_counting_allocations();
+    auto &state = thread_allocations();
+    state.peak_live_bytes = state.live_bytes;
+    return state;
+  }
+
+  const thread_allocation_state _start;
+};
+
+/**
+ * Run the function once and return the allocations that it made, for example
+ * to check that decoding an object performs at most a given number of
+ * allocations.
+ */
+template <typename function>
+allocation_counts count_allocations(const function &fn) {
+  const allocation_counter counter;
+  fn();
+  return counter.stop();
+}
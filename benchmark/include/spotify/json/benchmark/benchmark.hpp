@@ -18,25 +18,150 @@
 
 #include <chrono>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include <spotify/json/benchmark/allocation_counters.hpp>
+#include <spotify/json/benchmark/perf_counters.hpp>
+
+/**
+ * The measurements of one call to benchmark or benchmark_throughput. The
+ * results of all benchmarks in a run are kept in benchmark_results(), so that
+ * they can be written out in a machine readable format when the run is over.
+ */
+struct benchmark_result {
+  std::string name;
+  size_t runs = 0;
+  double total_ms = 0;
+  double us_avg = 0;
+  size_t bytes_per_run = 0;      // 0 if the benchmark does not measure throughput
+  size_t documents_per_run = 0;  // 0 if the benchmark does not measure throughput
+  std::map<std::string, double> counters;  // per run, when perf_counters are requested
+  double allocations_per_run = 0;
+  double bytes_allocated_per_run = 0;
+  size_t peak_live_bytes = 0;  // the most that a single run had allocated at once
+
+  double megabytes_per_second() const {
+    return total_ms ? (bytes_per_run * runs) / (total_ms * 1e3) : 0;
+  }
+
+  double documents_per_second() const {
+    return total_ms ? (documents_per_run * runs) / (total_ms * 1e-3) : 0;
+  }
+};
+
+inline std::vector<benchmark_result> &benchmark_results() {
+  static std::vector<benchmark_result> results;
+  return results;
+}
+
+inline void print_benchmark_counters(const benchmark_result &result) {
+  const auto print_per = [&](const char *unit, const size_t per_run) {
+    std::cerr << "  per " << unit << ":";
+    for (const auto &counter : result.counters) {
+      std::cerr << " " << (counter.second / per_run) << " " << counter.first;
+    }
+    std::cerr << std::endl;
+  };
+
+  if (result.bytes_per_run) {
+    print_per("byte", result.bytes_per_run);
+    print_per("document", result.documents_per_run);
+  } else {
+    print_per("run", 1);
+  }
+
+  const auto cycles = result.counters.find("cycles");
+  const auto instructions = result.counters.find("instructions");
+  if (cycles != result.counters.end() && instructions != result.counters.end() && cycles->second) {
+    std::cerr << "  " << (instructions->second / cycles->second) << " instructions per cycle" << std::endl;
+  }
+}
+
+/**
+ * Run the test function count times and report the throughput in MB/s and
+ * documents/s, given the number of bytes of JSON and the number of documents
+ * that each run of the test function decodes or encodes. When perf_counters
+ * are requested, the hardware counters are also reported per byte and per
+ * document, or per run for benchmarks that do not measure throughput. When
+ * allocation counting is requested, heap allocations are reported per run
+ * along with the peak live heap size.
+ */
 template <typename test_fn>
-void benchmark(const char *name, const size_t count, const test_fn &test) {
+void benchmark_throughput(
+    const char *name,
+    const size_t count,
+    const size_t bytes_per_run,
+    const size_t documents_per_run,
+    const test_fn &test) {
   using namespace std::chrono;
+  std::unique_ptr<perf_counters> counters;
+  if (perf_counters::requested()) {
+    counters.reset(new perf_counters());
+    counters->start();
+  }
+
+  std::unique_ptr<allocation_counter> allocations;
+  if (allocation_counter::requested()) {
+    allocations.reset(new allocation_counter());
+  }
+
   const auto before = high_resolution_clock::now();
   for (unsigned i = 0; i < count; i++) {
     test();
   }
   const auto after = high_resolution_clock::now();
+  const auto allocated = allocations ? allocations->stop() : allocation_counts();
+
+  benchmark_result result;
+  if (counters) {
+    const auto values = counters->stop();
+    for (size_t i = 0; i < perf_counters::num_counters; i++) {
+      if (values.available[i]) {
+        result.counters[perf_counters::name(perf_counters::counter(i))] = values.counts[i] / count;
+      }
+    }
+  }
 
   const auto duration = (after - before);
-  const auto duration_ms = duration_cast<milliseconds>(duration).count();
-  const auto duration_us = duration_cast<microseconds>(duration).count();
-  const auto duration_us_avg = (duration_us / static_cast<double>(count));
+  result.name = name;
+  result.runs = count;
+  result.total_ms = duration_cast<microseconds>(duration).count() / 1e3;
+  result.us_avg = (result.total_ms * 1e3) / static_cast<double>(count);
+  result.bytes_per_run = bytes_per_run;
+  result.documents_per_run = documents_per_run;
+  result.allocations_per_run = allocated.allocations / double(count);
+  result.bytes_allocated_per_run = allocated.bytes_allocated / double(count);
+  result.peak_live_bytes = allocated.peak_live_bytes;
+
   std::cerr
       << name << ": "
-      << duration_us_avg << " us avg (" << count << " runs), "
-      << duration_ms << " ms total"
-      << std::endl;
+      << result.us_avg << " us avg (" << count << " runs), "
+      << duration_cast<milliseconds>(duration).count() << " ms total";
+  if (bytes_per_run) {
+    std::cerr
+        << ", " << result.megabytes_per_second() << " MB/s"
+        << ", " << result.documents_per_second() << " documents/s";
+  }
+  std::cerr << std::endl;
+  if (allocations) {
+    std::cerr
+        << "  per run: " << result.allocations_per_run << " allocations, "
+        << result.bytes_allocated_per_run << " bytes allocated, "
+        << result.peak_live_bytes << " peak live bytes" << std::endl;
+  }
+  if (!result.counters.empty()) {
+    print_benchmark_counters(result);
+  }
+
+  benchmark_results().push_back(std::move(result));
+}
+
+template <typename test_fn>
+void benchmark(const char *name, const size_t count, const test_fn &test) {
+  benchmark_throughput(name, count, 0, 0, test);
 }
 
 #define JSON_BENCHMARK(n, test) \
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+/**
+ * Hardware performance counters for the benchmarks, read with the Linux
+ * perf_event_open system call. The counters are only opened when the
+ * SPOTIFY_JSON_BENCHMARK_COUNTERS environment variable is set. Each counter is
+ * opened on its own, so that the ones that the machine has can be reported
+ * even if others are missing. Counters that cannot be opened, because of the
+ * platform, virtualization or /proc/sys/kernel/perf_event_paranoid, are
+ * reported as unavailable instead of failing the benchmark.
+ */
+class perf_counters final {
+ public:
+  enum counter {
+    cycles,
+    instructions,
+    branch_misses,
+    l1d_misses,
+    llc_misses,
+    num_counters
+  };
+
+  struct values {
+    std::array<double, num_counters> counts{};
+    std::array<bool, num_counters> available{};
+  };
+
+  static const char *name(const counter c) {
+    static const char *NAMES[num_counters] = {
+      "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"
+    };
+    return NAMES[c];
+  }
+
+  static bool requested() {
+    const auto value = std::getenv("SPOTIFY_JSON_BENCHMARK_COUNTERS");
+    return value && *value && std::strcmp(value, "0") != 0;
+  }
+
+  perf_counters() {
+    _fds.fill(-1);
+#if defined(__linux__)
+    static const uint64_t L1D_READ_MISS =
+        PERF_COUNT_HW_CACHE_L1D |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    open(cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    open(instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    open(branch_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    open(l1d_misses, PERF_TYPE_HW_CACHE, L1D_READ_MISS);
+    open(llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif  // defined(__linux__)
+    warn_if_unavailable();
+  }
+
+  perf_counters(const perf_counters &) = delete;
+  perf_counters &operator=(const perf_counters &) = delete;
+
+  ~perf_counters() {
+#if defined(__linux__)
+    for (const auto fd : _fds) {
+      if (fd != -1) {
+        close(fd);
+      }
+    }
+#endif  // defined(__linux__)
+  }
+
+  void start() {
+#if defined(__linux__)
+    for (const auto fd : _fds) {
+      if (fd != -1) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif  // defined(__linux__)
+  }
+
+  /**
+   * Stop counting and return the counts since start. Counts are scaled up if
+   * the kernel had to multiplex the counters and only ran some of them part
+   * of the time.
+   */
+  values stop() {
+    values result;
+#if defined(__linux__)
+    for (const auto fd : _fds) {
+      if (fd != -1) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+
+    for (size_t i = 0; i < num_counters; i++) {
+      uint64_t data[3] = { 0, 0, 0 };  // value, time enabled, time running
+      if (_fds[i] == -1 || read(_fds[i], data, sizeof(data)) != sizeof(data) || !data[2]) {
+        continue;
+      }
+      result.counts[i] = double(data[0]) * (double(data[1]) / double(data[2]));
+      result.available[i] = true;
+    }
+#endif  // defined(__linux__)
+    return result;
+  }
+
+ private:
+#if defined(__linux__)
+  void open(const counter c, const uint32_t type, const uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    _fds[c] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    if (_fds[c] == -1) {
+      _error = errno;
+    }
+  }
+#endif  // defined(__linux__)
+
+  void warn_if_unavailable() const {
+    static bool warned = false;
+    if (warned) {
+      return;
+    }
+
+    for (size_t i = 0; i < num_counters; i++) {
+      if (_fds[i] == -1) {
+        std::cerr << "perf counter " << name(counter(i)) << " is unavailable";
+#if defined(__linux__)
+        std::cerr << " (" << std::strerror(_error) << ")";
+#endif  // defined(__linux__)
+        std::cerr << std::endl;
+        warned = true;
+      }
+    }
+  }
+
+  std::array<int, num_counters> _fds;
+#if defined(__linux__)
+  int _error = 0;
+#endif  // defined(__linux__)
+};
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+
+/**
+ * The parameters of a synthetic JSON workload. A workload document is an array
+ * of records. Each record is an object with a number of known fields, which
+ * workload_codec decodes, mixed with unknown fields that it skips. Records
+ * below the configured depth have a nested record in their "child" field.
+ */
+struct workload_options {
+  enum class number_kind {
+    small_integers,  // 0 to 999
+    large_integers,  // up to 2^62, positive and negative
+    decimals,        // two decimals, like prices
+    doubles,         // full precision, with exponents
+    mixed            // all of the above, decoded as doubles
+  };
+
+  enum class whitespace_style {
+    compact,  // no whitespace
+    spaced,   // a space after each : and ,
+    pretty    // one value per line, indented by two spaces per level
+  };
+
+  uint32_t seed = 1;
+  size_t records = 100;
+  size_t depth = 1;           // 1 means records without children
+  size_t width = 8;           // known fields per record, not counting "child"
+  double string_fields = 0.5;  // fraction of the known fields that are strings
+
+  // String lengths are uniformly distributed between these, in characters.
+  size_t min_string_length = 4;
+  size_t max_string_length = 32;
+  double escape_density = 0;   // fraction of string characters that are escaped
+  double non_ascii_ratio = 0;  // fraction of string characters that are multi-byte UTF-8
+
+  number_kind numbers = number_kind::small_integers;
+  whitespace_style whitespace = whitespace_style::compact;
+  double unknown_fields = 0;  // fraction of the fields of a record that are unknown
+
+  size_t num_string_fields() const {
+    return size_t(width * string_fields + 0.5);
+  }
+
+  bool integer_numbers() const {
+    return numbers == number_kind::small_integers || numbers == number_kind::large_integers;
+  }
+};
+
+/**
+ * A decoded workload record. Known string fields are kept in strings, and the
+ * known number fields in integers or decimals depending on the number kind.
+ */
+struct workload_record {
+  std::vector<std::string> strings;
+  std::vector<int64_t> integers;
+  std::vector<double> decimals;
+  std::vector<workload_record> children;  // the "child" field, if any
+};
+
+/**
+ * Writes workload documents. Values are derived from the raw output of
+ * std::mt19937, which is the same on every platform, so a seed always gives
+ * the same bytes.
+ */
+class workload_generator final {
+ public:
+  explicit workload_generator(const workload_options &options)
+      : _options(options),
+        _random(options.seed) {}
+
+  std::string document() {
+    std::string out;
+    out += '[';
+    for (size_t i = 0; i < _options.records; i++) {
+      out += (i ? "," : "");
+      newline(out, 1);
+      record(out, 1);
+    }
+    newline(out, 0);
+    out += ']';
+    return out;
+  }
+
+ private:
+  void record(std::string &out, const size_t level) {
+    const auto width = _options.width;
+    const auto num_unknown = size_t(width * _options.unknown_fields / (1 - _options.unknown_fields) + 0.5);
+    auto num_fields = size_t(0);
+    auto unknown_written = size_t(0);
+
+    out += '{';
+    for (size_t i = 0; i < width; i++) {
+      // Spread the unknown fields evenly between the known ones
+      for (; unknown_written * width < num_unknown * (i + 1); unknown_written++) {
+        key(out, num_fields++, level, "unknown_" + std::to_string(unknown_written));
+        unknown_value(out, level);
+      }
+      key(out, num_fields++, level, "field_" + std::to_string(i));
+      if (i < _options.num_string_fields()) {
+        string_value(out);
+      } else {
+        number_value(out);
+      }
+    }
+    if (level < _options.depth) {
+      key(out, num_fields++, level, "child");
+      record(out, level + 1);
+    }
+    newline(out, level - 1);
+    out += '}';
+  }
+
+  void key(std::string &out, const size_t index, const size_t level, const std::string &name) {
+    out += (index ? "," : "");
+    newline(out, level);
+    out += '"';
+    out += name;
+    out += (_options.whitespace == workload_options::whitespace_style::compact ? "\":" : "\": ");
+  }
+
+  void newline(std::string &out, const size_t level) {
+    switch (_options.whitespace) {
+      case workload_options::whitespace_style::compact: break;
+      case workload_options::whitespace_style::spaced: out += (out.back() == ',' ? " " : ""); break;
+      case workload_options::whitespace_style::pretty: out += '\n'; out.append(2 * level, ' '); break;
+    }
+  }
+
+  bool chance(const double probability) {
+    return _random() < probability * 4294967296.0;
+  }
+
+  uint32_t integer(const uint32_t max) {
+    return _random() % (max + 1);
+  }
+
+  void string_value(std::string &out) {
+    static const char *ESCAPES[] = { "\\\"", "\\\\", "\\n", "\\t", "\\/", "\\u0001", "\\u00e9" };
+    static const char *NON_ASCII[] = { "\xC3\xA9", "\xE2\x82\xAC", "\xE6\x97\xA5", "\xF0\x9F\x8E\xB5" };
+
+    const auto length_range = _options.max_string_length - _options.min_string_length;
+    const auto length = _options.min_string_length + integer(uint32_t(length_range));
+    out += '"';
+    for (size_t i = 0; i < length; i++) {
+      if (_options.escape_density && chance(_options.escape_density)) {
+        out += ESCAPES[integer(6)];
+      } else if (_options.non_ascii_ratio && chance(_options.non_ascii_ratio)) {
+        out += NON_ASCII[integer(3)];
+      } else {
+        out += char('a' + integer(25));
+      }
+    }
+    out += '"';
+  }
+
+  void number_value(std::string &out) {
+    using number_kind = workload_options::number_kind;
+    auto kind = _options.numbers;
+    if (kind == number_kind::mixed) {
+      kind = number_kind(integer(3));
+    }
+
+    char buffer[32];
+    switch (kind) {
+      case number_kind::small_integers:
+        out += std::to_string(integer(999));
+        break;
+      case number_kind::large_integers: {
+        const auto value = int64_t((uint64_t(_random()) << 30) ^ _random());
+        out += std::to_string(integer(1) ? value : -value);
+        break;
+      }
+      case number_kind::decimals:
+        std::snprintf(buffer, sizeof(buffer), "%u.%02u", integer(9999), integer(99));
+        out += buffer;
+        break;
+      default: {
+        const auto mantissa = double((uint64_t(_random()) << 21) ^ _random()) / 9007199254740992.0;
+        const auto exponent = int(integer(40)) - 20;
+        std::snprintf(buffer, sizeof(buffer), "%.17g", (integer(1) ? 1 : -1) * mantissa * std::pow(10.0, exponent));
+        out += buffer;
+        break;
+      }
+    }
+  }
+
+  void unknown_value(std::string &out, const size_t level) {
+    switch (integer(3)) {
+      case 0: string_value(out); break;
+      case 1: number_value(out); break;
+      case 2:
+        out += '[';
+        for (auto n = integer(4), i = 0u; i <= n; i++) {
+          out += (i ? "," : "");
+          number_value(out);
+        }
+        out += ']';
+        break;
+      default:
+        out += '{';
+        key(out, 0, level + 1, "id");
+        number_value(out);
+        key(out, 1, level + 1, "name");
+        string_value(out);
+        newline(out, level);
+        out += '}';
+        break;
+    }
+  }
+
+  const workload_options _options;
+  std::mt19937 _random;
+};
+
+inline std::string generate_workload(const workload_options &options) {
+  return workload_generator(options).document();
+}
+
+/**
+ * A codec for the records of a workload. Unknown fields are skipped, since
+ * object_t ignores fields that it does not know.
+ */
+inline spotify::json::codec::object_t<workload_record> workload_codec(
+    const workload_options &options,
+    const size_t level = 1) {
+  using namespace spotify::json;
+  codec::object_t<workload_record> codec;
+
+  for (size_t i = 0; i < options.width; i++) {
+    const auto name = "field_" + std::to_string(i);
+    if (i < options.num_string_fields()) {
+      codec.required(name,
+          [i](const workload_record &record) -> const std::string & { return record.strings[i]; },
+          [i](workload_record &record, std::string value) {
+            record.strings.resize(std::max(record.strings.size(), i + 1));
+            record.strings[i] = std::move(value);
+          });
+    } else if (options.integer_numbers()) {
+      const auto j = i - options.num_string_fields();
+      codec.required(name,
+          [j](const workload_record &record) { return record.integers[j]; },
+          [j](workload_record &record, int64_t value) {
+            record.integers.resize(std::max(record.integers.size(), j + 1));
+            record.integers[j] = value;
+          });
+    } else {
+      const auto j = i - options.num_string_fields();
+      codec.required(name,
+          [j](const workload_record &record) { return record.decimals[j]; },
+          [j](workload_record &record, double value) {
+            record.decimals.resize(std::max(record.decimals.size(), j + 1));
+            record.decimals[j] = value;
+          });
+    }
+  }
+
+  if (level < options.depth) {
+    codec.required("child",
+        [](const workload_record &record) -> const workload_record & { return record.children.front(); },
+        [](workload_record &record, workload_record child) { record.children.assign(1, std::move(child)); },
+        workload_codec(options, level + 1));
+  }
+
+  return codec;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/benchmark/allocation_counters.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer) || __has_feature(thread_sanitizer)
+#define JSON_BENCHMARK_SANITIZED 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define JSON_BENCHMARK_SANITIZED 1
+#endif
+
+#if defined(__GLIBC__) && !defined(JSON_BENCHMARK_SANITIZED)
+#define JSON_BENCHMARK_COUNT_ALLOCATIONS 1
+#include <malloc.h>
+#endif
+
+namespace {
+
+thread_local thread_allocation_state state = {};
+
+/**
+ * The number of allocation_counter objects in all threads. The replacement
+ * functions check it before touching the thread local state, so that outside
+ * of counted sections they cost one relaxed load on top of the C library.
+ */
+std::atomic<size_t> running_counters(0);
+
+#if defined(JSON_BENCHMARK_COUNT_ALLOCATIONS)
+
+bool counting() {
+  return running_counters.load(std::memory_order_relaxed) && state.running_counters;
+}
+
+void count_allocation(void *ptr, const size_t size) {
+  if (ptr && counting()) {
+    state.allocations++;
+    state.bytes_allocated += size;
+    state.live_bytes += int64_t(malloc_usable_size(ptr));
+    if (state.live_bytes > state.peak_live_bytes) {
+      state.peak_live_bytes = state.live_bytes;
+    }
+  }
+}
+
+void count_free(void *ptr) {
+  if (ptr && counting()) {
+    state.live_bytes -= int64_t(malloc_usable_size(ptr));
+  }
+}
+
+#endif  // defined(JSON_BENCHMARK_COUNT_ALLOCATIONS)
+
+}  // namespace
+
+thread_allocation_state &thread_allocations() {
+  return state;
+}
+
+void start_counting_allocations() {
+  state.running_counters++;
+  running_counters.fetch_add(1, std::memory_order_relaxed);
+}
+
+void stop_counting_allocations() {
+  running_counters.fetch_sub(1, std::memory_order_relaxed);
+  state.running_counters--;
+}
+
+bool allocation_counting_available() {
+#if defined(JSON_BENCHMARK_COUNT_ALLOCATIONS)
+  return true;
+#else
+  return false;
+#endif  // defined(JSON_BENCHMARK_COUNT_ALLOCATIONS)
+}
+
+#if defined(JSON_BENCHMARK_COUNT_ALLOCATIONS)
+
+/*
+ * glibc allows an executable to replace malloc, as long as it provides malloc,
+ * free, calloc and realloc, and also the aligned functions if they are used.
+ * The replacements count and then forward to the glibc implementations, so the
+ * heap itself, including malloc_usable_size, stays the same. operator new is
+ * implemented on top of malloc, so C++ allocations are counted as well. Only
+ * threads with a running allocation_counter are counted.
+ */
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+  const auto ptr = __libc_malloc(size);
+  count_allocation(ptr, size);
+  return ptr;
+}
+
+void *calloc(size_t count, size_t size) {
+  const auto ptr = __libc_calloc(count, size);
+  count_allocation(ptr, count * size);
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+  if (!counting()) {
+    return __libc_realloc(ptr, size);
+  }
+
+  const auto old_size = ptr ? malloc_usable_size(ptr) : 0;
+  const auto new_ptr = __libc_realloc(ptr, size);
+  if (new_ptr || !size) {
+    state.live_bytes -= int64_t(old_size);
+  }
+  count_allocation(new_ptr, size);
+  return new_ptr;
+}
+
+void *memalign(size_t alignment, size_t size) {
+  const auto ptr = __libc_memalign(alignment, size);
+  count_allocation(ptr, size);
+  return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+  return memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+  if (alignment % sizeof(void *) || (alignment & (alignment - 1))) {
+    return EINVAL;
+  }
+  const auto result = memalign(alignment, size);
+  if (!result) {
+    return ENOMEM;
+  }
+  *ptr = result;
+  return 0;
+}
+
+void free(void *ptr) {
+  count_free(ptr);
+  __libc_free(ptr);
+}
+
+}  // extern "C"
+
+#endif  // defined(JSON_BENCHMARK_COUNT_ALLOCATIONS)
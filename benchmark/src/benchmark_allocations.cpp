@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/benchmark/allocation_counters.hpp>
+
+/*
+ * These test cases lock in how many heap allocations common operations make,
+ * so that a change that adds allocations to a hot path fails the benchmark
+ * run. They are skipped where allocation_counter is not available.
+ */
+
+#define REQUIRE_ALLOCATION_COUNTER() \
+  if (!allocation_counter::available()) { \
+    BOOST_TEST_MESSAGE("allocation counting is not available"); \
+    return; \
+  }
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct allocation_playlist_t {
+  std::string name;
+  std::vector<std::string> tracks;
+  int length = 0;
+};
+
+codec::object_t<allocation_playlist_t> allocation_playlist_codec() {
+  auto codec = codec::object<allocation_playlist_t>();
+  codec.required("name", &allocation_playlist_t::name);
+  codec.required("tracks", &allocation_playlist_t::tracks);
+  codec.optional("length", &allocation_playlist_t::length);
+  return codec;
+}
+
+std::string allocation_playlist_json(const size_t num_tracks) {
+  std::string json = R"({"name":"A playlist name that does not fit in a small string","tracks":[)";
+  for (size_t i = 0; i < num_tracks; i++) {
+    json += (i ? "," : "");
+    json += "\"spotify:track:" + std::string(22, char('a' + (i % 26))) + '"';
+  }
+  json += R"(],"length":10,"unknown":{"a":[1,2,3],"b":"a string that is skipped and not copied"}})";
+  return json;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_decode_number) {
+  REQUIRE_ALLOCATION_COUNTER();
+  const auto counts = count_allocations([] { decode<int>("123456"); });
+  BOOST_CHECK_EQUAL(counts.allocations, 0);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_decode_string) {
+  REQUIRE_ALLOCATION_COUNTER();
+  const auto json = std::string(R"("a string that is too long to fit in a small string")");
+  const auto counts = count_allocations([&] { decode<std::string>(json); });
+  BOOST_CHECK_EQUAL(counts.allocations, 1);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_decode_escaped_string) {
+  REQUIRE_ALLOCATION_COUNTER();
+  const auto json = std::string(R"("a string that is too long to fit in a small string\nand has escapes")");
+  const auto counts = count_allocations([&] { decode<std::string>(json); });
+  BOOST_CHECK_EQUAL(counts.allocations, 1);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_decode_object) {
+  REQUIRE_ALLOCATION_COUNTER();
+  const auto codec = allocation_playlist_codec();
+  const auto json = allocation_playlist_json(100);
+  const auto counts = count_allocations([&] { decode(codec, json); });
+  // One for the name, one per track and the growth of the tracks vector
+  BOOST_CHECK_LE(counts.allocations, 1 + 100 + 8);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_skip_unknown_fields) {
+  REQUIRE_ALLOCATION_COUNTER();
+  auto codec = codec::object<allocation_playlist_t>();
+  codec.optional("length", &allocation_playlist_t::length);
+  const auto json = allocation_playlist_json(100);
+  const auto counts = count_allocations([&] { decode(codec, json); });
+  BOOST_CHECK_EQUAL(counts.allocations, 0);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_decode_into_object) {
+  REQUIRE_ALLOCATION_COUNTER();
+  const auto codec = allocation_playlist_codec();
+  const auto json = allocation_playlist_json(100);
+  auto playlist = decode(codec, json);
+  const auto counts = count_allocations([&] { decode_into(codec, json, playlist); });
+  BOOST_CHECK_EQUAL(counts.allocations, 0);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_encode_object) {
+  REQUIRE_ALLOCATION_COUNTER();
+  const auto codec = allocation_playlist_codec();
+  const auto playlist = decode(codec, allocation_playlist_json(100));
+  const auto counts = count_allocations([&] { encode(codec, playlist); });
+  // The encode buffer, growing it once, and the returned string. The strings
+  // of the object are not copied.
+  BOOST_CHECK_LE(counts.allocations, 3);
+  BOOST_CHECK_LE(counts.peak_live_bytes, 3 * 8192);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_allocations_encode_number) {
+  REQUIRE_ALLOCATION_COUNTER();
+  const auto counts = count_allocations([] { encode(123456); });
+  // Only the encode buffer; the result fits in a small string
+  BOOST_CHECK_EQUAL(counts.allocations, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
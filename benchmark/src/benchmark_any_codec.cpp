@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/any_codec.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/optional.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+std::string generate_number_array_json(size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? "," : "") + std::to_string(i);
+  }
+  return json + "]";
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_any_codec_construct) {
+  JSON_BENCHMARK(1e6, [] {
+    const auto codec = any_codec(optional(string()));
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_any_codec_copy) {
+  const auto codec = any_codec(optional(string()));
+  JSON_BENCHMARK(1e6, [&] {
+    const auto copy = codec;
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_any_codec_decode_number_array) {
+  const auto codec = array<std::vector<int>>(any_codec(number<int>()));
+  const auto json = generate_number_array_json(10000);
+  JSON_BENCHMARK(1e3, [&] {
+    decode(codec, json);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_any_codec_decode_number_array_without_any_codec) {
+  const auto codec = array<std::vector<int>>(number<int>());
+  const auto json = generate_number_array_json(10000);
+  JSON_BENCHMARK(1e3, [&] {
+    decode(codec, json);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
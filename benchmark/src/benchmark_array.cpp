@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct track_t {
+  std::string uri;
+  std::string name;
+  int duration = 0;
+};
+
+object_t<track_t> track_codec() {
+  auto codec = object<track_t>();
+  codec.required("uri", &track_t::uri);
+  codec.required("name", &track_t::name);
+  codec.required("duration", &track_t::duration);
+  return codec;
+}
+
+std::string generate_string_array_json(size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? ",\"spotify:track:" : "\"spotify:track:") + std::to_string(i) + "\"";
+  }
+  return json + "]";
+}
+
+std::string generate_object_array_json(size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? "," : "");
+    json += "{\"uri\":\"spotify:track:" + std::to_string(i) + "\",";
+    json += "\"name\":\"A track name that does not fit in a small string\",";
+    json += "\"duration\":" + std::to_string(i) + "}";
+  }
+  return json + "]";
+}
+
+template <typename codec_type>
+void benchmark_decode(const char *name, const codec_type &codec, const std::string &json, size_t runs) {
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  benchmark(name, runs, [&]{
+    auto context = decode_context(json_begin, json_end);
+    codec.decode(context);
+  });
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_decode_strings) {
+  const auto codec = array<std::vector<std::string>>(string());
+  benchmark_decode(typeid(*this).name(), codec, generate_string_array_json(100000), 20);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_decode_strings_counted) {
+  const auto codec = counted_array<std::vector<std::string>>(string());
+  benchmark_decode(typeid(*this).name(), codec, generate_string_array_json(100000), 20);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_decode_objects) {
+  const auto codec = array<std::vector<track_t>>(track_codec());
+  benchmark_decode(typeid(*this).name(), codec, generate_object_array_json(100000), 20);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_array_decode_objects_counted) {
+  const auto codec = counted_array<std::vector<track_t>>(track_codec());
+  benchmark_decode(typeid(*this).name(), codec, generate_object_array_json(100000), 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
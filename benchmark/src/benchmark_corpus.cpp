@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/optional.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/padded_buffer.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+/*
+ * The corpus benchmarks measure decoding and encoding throughput on documents
+ * shaped like common public JSON: tweets, a product catalog, GeoJSON and a
+ * deeply nested tree. The documents are generated from a fixed seed, so every
+ * run and every machine sees the same bytes.
+ */
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct tweet_user_t {
+  uint64_t id = 0;
+  std::string screen_name;
+  std::string name;
+  std::string description;
+  std::string location;
+  uint32_t followers_count = 0;
+  uint32_t friends_count = 0;
+  bool verified = false;
+};
+
+struct tweet_t {
+  uint64_t id = 0;
+  std::string id_str;
+  std::string created_at;
+  std::string text;
+  std::string source;
+  tweet_user_t user;
+  std::vector<std::string> hashtags;
+  std::vector<uint64_t> user_mentions;
+  std::optional<uint64_t> in_reply_to_status_id;
+  uint32_t retweet_count = 0;
+  uint32_t favorite_count = 0;
+  bool favorited = false;
+  bool retweeted = false;
+  std::string lang;
+};
+
+struct product_variant_t {
+  std::string sku;
+  std::string size;
+  double price = 0;
+  uint32_t stock = 0;
+};
+
+struct product_t {
+  std::string sku;
+  std::string title;
+  std::string description;
+  std::string brand;
+  double price = 0;
+  std::string currency;
+  bool in_stock = false;
+  double rating = 0;
+  uint32_t review_count = 0;
+  std::vector<std::string> categories;
+  std::map<std::string, std::string> attributes;
+  std::vector<product_variant_t> variants;
+};
+
+struct geo_properties_t {
+  std::string name;
+  uint64_t population = 0;
+  double area = 0;
+};
+
+struct geo_geometry_t {
+  std::string type;
+  std::vector<std::vector<std::vector<double>>> coordinates;
+};
+
+struct geo_feature_t {
+  std::string type;
+  geo_properties_t properties;
+  geo_geometry_t geometry;
+};
+
+struct geo_feature_collection_t {
+  std::string type;
+  std::vector<geo_feature_t> features;
+};
+
+struct tree_node_t {
+  std::string name;
+  int32_t value = 0;
+  std::vector<tree_node_t> children;
+};
+
+/**
+ * Refers to the tree_node_t codec from inside itself, for the children field.
+ */
+struct tree_node_codec_ref_t {
+  using object_type = tree_node_t;
+  object_type decode(decode_context &context) const;
+  void encode(encode_context &context, const object_type &value) const;
+};
+
+const codec::object_t<tree_node_t> &tree_node_codec() {
+  static const auto codec = [] {
+    codec::object_t<tree_node_t> codec;
+    codec.required("name", &tree_node_t::name);
+    codec.required("value", &tree_node_t::value);
+    codec.optional("children", &tree_node_t::children,
+        codec::array<std::vector<tree_node_t>>(tree_node_codec_ref_t()));
+    return codec;
+  }();
+  return codec;
+}
+
+tree_node_t tree_node_codec_ref_t::decode(decode_context &context) const {
+  return tree_node_codec().decode(context);
+}
+
+void tree_node_codec_ref_t::encode(encode_context &context, const tree_node_t &value) const {
+  tree_node_codec().encode(context, value);
+}
+
+}  // namespace
+
+template <>
+struct default_codec_t<tweet_user_t> {
+  static codec::object_t<tweet_user_t> codec() {
+    codec::object_t<tweet_user_t> codec;
+    codec.required("id", &tweet_user_t::id);
+    codec.required("screen_name", &tweet_user_t::screen_name);
+    codec.required("name", &tweet_user_t::name);
+    codec.optional("description", &tweet_user_t::description);
+    codec.optional("location", &tweet_user_t::location);
+    codec.required("followers_count", &tweet_user_t::followers_count);
+    codec.required("friends_count", &tweet_user_t::friends_count);
+    codec.required("verified", &tweet_user_t::verified);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<tweet_t> {
+  static codec::object_t<tweet_t> codec() {
+    codec::object_t<tweet_t> codec;
+    codec.required("id", &tweet_t::id);
+    codec.required("id_str", &tweet_t::id_str);
+    codec.required("created_at", &tweet_t::created_at);
+    codec.required("text", &tweet_t::text);
+    codec.optional("source", &tweet_t::source);
+    codec.required("user", &tweet_t::user);
+    codec.optional("hashtags", &tweet_t::hashtags);
+    codec.optional("user_mentions", &tweet_t::user_mentions);
+    codec.optional("in_reply_to_status_id", &tweet_t::in_reply_to_status_id);
+    codec.required("retweet_count", &tweet_t::retweet_count);
+    codec.required("favorite_count", &tweet_t::favorite_count);
+    codec.required("favorited", &tweet_t::favorited);
+    codec.required("retweeted", &tweet_t::retweeted);
+    codec.optional("lang", &tweet_t::lang);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<product_variant_t> {
+  static codec::object_t<product_variant_t> codec() {
+    codec::object_t<product_variant_t> codec;
+    codec.required("sku", &product_variant_t::sku);
+    codec.optional("size", &product_variant_t::size);
+    codec.required("price", &product_variant_t::price);
+    codec.required("stock", &product_variant_t::stock);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<product_t> {
+  static codec::object_t<product_t> codec() {
+    codec::object_t<product_t> codec;
+    codec.required("sku", &product_t::sku);
+    codec.required("title", &product_t::title);
+    codec.optional("description", &product_t::description);
+    codec.optional("brand", &product_t::brand);
+    codec.required("price", &product_t::price);
+    codec.required("currency", &product_t::currency);
+    codec.required("in_stock", &product_t::in_stock);
+    codec.optional("rating", &product_t::rating);
+    codec.optional("review_count", &product_t::review_count);
+    codec.optional("categories", &product_t::categories);
+    codec.optional("attributes", &product_t::attributes);
+    codec.optional("variants", &product_t::variants);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<geo_properties_t> {
+  static codec::object_t<geo_properties_t> codec() {
+    codec::object_t<geo_properties_t> codec;
+    codec.required("name", &geo_properties_t::name);
+    codec.optional("population", &geo_properties_t::population);
+    codec.optional("area", &geo_properties_t::area);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<geo_geometry_t> {
+  static codec::object_t<geo_geometry_t> codec() {
+    codec::object_t<geo_geometry_t> codec;
+    codec.required("type", &geo_geometry_t::type);
+    codec.required("coordinates", &geo_geometry_t::coordinates);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<geo_feature_t> {
+  static codec::object_t<geo_feature_t> codec() {
+    codec::object_t<geo_feature_t> codec;
+    codec.required("type", &geo_feature_t::type);
+    codec.required("properties", &geo_feature_t::properties);
+    codec.required("geometry", &geo_feature_t::geometry);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<geo_feature_collection_t> {
+  static codec::object_t<geo_feature_collection_t> codec() {
+    codec::object_t<geo_feature_collection_t> codec;
+    codec.required("type", &geo_feature_collection_t::type);
+    codec.required("features", &geo_feature_collection_t::features);
+    return codec;
+  }
+};
+
+template <>
+struct default_codec_t<tree_node_t> {
+  static const codec::object_t<tree_node_t> &codec() {
+    return tree_node_codec();
+  }
+};
+
+namespace {
+
+/**
+ * Generates the contents of the corpus documents. std::mt19937 produces the
+ * same sequence on every platform, unlike the standard distributions, so
+ * values are derived from its raw output.
+ */
+class corpus_generator {
+ public:
+  explicit corpus_generator(uint32_t seed) : _random(seed) {}
+
+  uint32_t integer(uint32_t max) {
+    return _random() % (max + 1);
+  }
+
+  uint64_t id() {
+    return (uint64_t(_random()) << 20) ^ _random();
+  }
+
+  bool chance(uint32_t percent) {
+    return integer(99) < percent;
+  }
+
+  double decimal(double min, double max, double scale) {
+    return round(min + (max - min) * (_random() / 4294967296.0), scale);
+  }
+
+  static double round(double value, double scale) {
+    return std::round(value * scale) / scale;
+  }
+
+  template <typename T, size_t n>
+  const T &pick(const T (&values)[n]) {
+    return values[integer(n - 1)];
+  }
+
+  std::string words(size_t count) {
+    static const char *WORDS[] = {
+      "the", "music", "of", "a", "new", "playlist", "tonight", "listening",
+      "concert", "album", "release", "tour", "live", "summer", "best", "ever",
+      "caf\xC3\xA9", "m\xC3\xBCsik", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E",
+      "\xF0\x9F\x8E\xB5", "\xF0\x9F\x94\xA5", "\"quoted\"", "line\nbreak",
+      "https://open.spotify.com/track/4uLU6hMCjMI75M1A2tKUQC"
+    };
+
+    std::string text;
+    for (size_t i = 0; i < count; i++) {
+      text += (i ? " " : "");
+      text += pick(WORDS);
+    }
+    return text;
+  }
+
+  std::string token(const char *prefix, size_t length) {
+    static const char CHARS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    std::string token(prefix);
+    for (size_t i = 0; i < length; i++) {
+      token += CHARS[integer(sizeof(CHARS) - 2)];
+    }
+    return token;
+  }
+
+ private:
+  std::mt19937 _random;
+};
+
+tweet_t generate_tweet(corpus_generator &generator) {
+  static const char *LANGUAGES[] = { "en", "sv", "ja", "de", "es", "fr" };
+  static const char *SOURCES[] = {
+    "<a href=\"https://mobile.twitter.com\" rel=\"nofollow\">Twitter Web App</a>",
+    "<a href=\"http://twitter.com/download/iphone\" rel=\"nofollow\">Twitter for iPhone</a>"
+  };
+
+  tweet_t tweet;
+  tweet.id = generator.id();
+  tweet.id_str = std::to_string(tweet.id);
+  tweet.created_at = "Mon Sep 24 03:35:21 +0000 2018";
+  tweet.text = generator.words(8 + generator.integer(20));
+  tweet.source = generator.pick(SOURCES);
+  tweet.user.id = generator.id();
+  tweet.user.screen_name = generator.token("", 6 + generator.integer(8));
+  tweet.user.name = generator.words(2);
+  tweet.user.description = generator.words(generator.integer(16));
+  tweet.user.location = generator.chance(60) ? generator.words(2) : "";
+  tweet.user.followers_count = generator.integer(1000000);
+  tweet.user.friends_count = generator.integer(5000);
+  tweet.user.verified = generator.chance(5);
+  for (auto i = generator.integer(3); i > 0; i--) {
+    tweet.hashtags.push_back(generator.token("", 4 + generator.integer(10)));
+  }
+  for (auto i = generator.integer(3); i > 0; i--) {
+    tweet.user_mentions.push_back(generator.id());
+  }
+  if (generator.chance(30)) {
+    tweet.in_reply_to_status_id = generator.id();
+  }
+  tweet.retweet_count = generator.integer(10000);
+  tweet.favorite_count = generator.integer(50000);
+  tweet.favorited = generator.chance(10);
+  tweet.retweeted = generator.chance(10);
+  tweet.lang = generator.pick(LANGUAGES);
+  return tweet;
+}
+
+product_t generate_product(corpus_generator &generator) {
+  static const char *BRANDS[] = { "Acme", "Globex", "Initech", "Umbrella", "Hooli" };
+  static const char *CATEGORIES[] = { "audio", "headphones", "speakers", "vinyl", "accessories", "merch" };
+  static const char *COLORS[] = { "black", "white", "red", "blue", "green" };
+  static const char *SIZES[] = { "XS", "S", "M", "L", "XL" };
+
+  product_t product;
+  product.sku = generator.token("SKU-", 10);
+  product.title = generator.words(3 + generator.integer(5));
+  product.description = generator.words(20 + generator.integer(40));
+  product.brand = generator.pick(BRANDS);
+  product.price = generator.decimal(1, 500, 100);
+  product.currency = "USD";
+  product.in_stock = generator.chance(80);
+  product.rating = generator.decimal(1, 5, 10);
+  product.review_count = generator.integer(5000);
+  for (auto i = 1 + generator.integer(3); i > 0; i--) {
+    product.categories.push_back(generator.pick(CATEGORIES));
+  }
+  product.attributes["color"] = generator.pick(COLORS);
+  product.attributes["material"] = generator.words(1);
+  product.attributes["origin"] = generator.words(2);
+  for (auto i = generator.integer(5); i > 0; i--) {
+    product_variant_t variant;
+    variant.sku = generator.token("SKU-", 12);
+    variant.size = generator.pick(SIZES);
+    variant.price = generator.decimal(1, 500, 100);
+    variant.stock = generator.integer(1000);
+    product.variants.push_back(std::move(variant));
+  }
+  return product;
+}
+
+geo_feature_t generate_geo_feature(corpus_generator &generator) {
+  geo_feature_t feature;
+  feature.type = "Feature";
+  feature.properties.name = generator.words(2);
+  feature.properties.population = generator.integer(10000000);
+  feature.properties.area = generator.decimal(0, 100000, 1000);
+  feature.geometry.type = "Polygon";
+
+  const auto lon = generator.decimal(-170, 170, 1e6);
+  const auto lat = generator.decimal(-80, 80, 1e6);
+  for (auto rings = 1 + generator.integer(1); rings > 0; rings--) {
+    std::vector<std::vector<double>> ring;
+    for (auto points = 50 + generator.integer(150); points > 0; points--) {
+      ring.push_back({
+          corpus_generator::round(lon + generator.decimal(-1, 1, 1e6), 1e6),
+          corpus_generator::round(lat + generator.decimal(-1, 1, 1e6), 1e6) });
+    }
+    ring.push_back(ring.front());
+    feature.geometry.coordinates.push_back(std::move(ring));
+  }
+  return feature;
+}
+
+/**
+ * A chain of nodes, each with a leaf as a sibling of the next node in the
+ * chain, so that the nesting depth grows linearly with the size.
+ */
+tree_node_t generate_tree(corpus_generator &generator, size_t depth) {
+  tree_node_t node;
+  node.name = generator.token("node-", 6);
+  node.value = int32_t(generator.integer(1000000)) - 500000;
+  if (depth) {
+    node.children.push_back(generate_tree(generator, depth - 1));
+    tree_node_t leaf;
+    leaf.name = generator.token("leaf-", 4);
+    leaf.value = int32_t(generator.integer(100));
+    node.children.push_back(std::move(leaf));
+  }
+  return node;
+}
+
+template <typename T>
+struct corpus_t {
+  std::vector<T> values;
+  std::vector<std::string> documents;
+  std::vector<padded_buffer> padded_documents;
+  size_t bytes = 0;
+};
+
+template <typename T, typename generate_fn>
+corpus_t<T> generate_corpus(size_t num_documents, generate_fn generate) {
+  corpus_generator generator(0x5EED);
+  corpus_t<T> corpus;
+  for (size_t i = 0; i < num_documents; i++) {
+    corpus.values.push_back(generate(generator));
+    corpus.documents.push_back(encode(corpus.values.back()));
+    corpus.padded_documents.emplace_back(corpus.documents.back());
+    corpus.bytes += corpus.documents.back().size();
+  }
+  return corpus;
+}
+
+const corpus_t<std::vector<tweet_t>> &tweets_corpus() {
+  static const auto corpus = generate_corpus<std::vector<tweet_t>>(100, [](corpus_generator &generator) {
+    std::vector<tweet_t> timeline;
+    for (int i = 0; i < 20; i++) {
+      timeline.push_back(generate_tweet(generator));
+    }
+    return timeline;
+  });
+  return corpus;
+}
+
+const corpus_t<std::vector<product_t>> &catalog_corpus() {
+  static const auto corpus = generate_corpus<std::vector<product_t>>(40, [](corpus_generator &generator) {
+    std::vector<product_t> page;
+    for (int i = 0; i < 50; i++) {
+      page.push_back(generate_product(generator));
+    }
+    return page;
+  });
+  return corpus;
+}
+
+const corpus_t<geo_feature_collection_t> &geo_corpus() {
+  static const auto corpus = generate_corpus<geo_feature_collection_t>(20, [](corpus_generator &generator) {
+    geo_feature_collection_t collection;
+    collection.type = "FeatureCollection";
+    for (int i = 0; i < 10; i++) {
+      collection.features.push_back(generate_geo_feature(generator));
+    }
+    return collection;
+  });
+  return corpus;
+}
+
+const corpus_t<tree_node_t> &nested_corpus() {
+  static const auto corpus = generate_corpus<tree_node_t>(200, [](corpus_generator &generator) {
+    return generate_tree(generator, 48);
+  });
+  return corpus;
+}
+
+template <typename T>
+void benchmark_decode_corpus(const char *name, const corpus_t<T> &corpus, size_t runs) {
+  const auto codec = default_codec<T>();
+  benchmark_throughput(name, runs, corpus.bytes, corpus.documents.size(), [&]{
+    for (const auto &document : corpus.documents) {
+      auto context = decode_context(document.data(), document.size());
+      const auto value = codec.decode(context);
+    }
+  });
+}
+
+/**
+ * Like benchmark_decode_corpus, but decodes copies of the documents that are
+ * followed by padding, which lets the string and whitespace scanners run to
+ * the end of the input with full width loads.
+ */
+template <typename T>
+void benchmark_decode_padded_corpus(const char *name, const corpus_t<T> &corpus, size_t runs) {
+  const auto codec = default_codec<T>();
+  benchmark_throughput(name, runs, corpus.bytes, corpus.documents.size(), [&]{
+    for (const auto &document : corpus.padded_documents) {
+      auto context = decode_context(static_cast<padded_string_view>(document));
+      const auto value = codec.decode(context);
+    }
+  });
+}
+
+template <typename T>
+void benchmark_encode_corpus(const char *name, const corpus_t<T> &corpus, size_t runs) {
+  const auto codec = default_codec<T>();
+  encode_context context;
+  benchmark_throughput(name, runs, corpus.bytes, corpus.documents.size(), [&]{
+    for (const auto &value : corpus.values) {
+      codec.encode(context, value);
+      context.clear();
+    }
+  });
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_tweets_decode) {
+  benchmark_decode_corpus(typeid(*this).name(), tweets_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_tweets_decode_padded) {
+  benchmark_decode_padded_corpus(typeid(*this).name(), tweets_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_catalog_decode) {
+  benchmark_decode_corpus(typeid(*this).name(), catalog_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_catalog_decode_padded) {
+  benchmark_decode_padded_corpus(typeid(*this).name(), catalog_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_geo_decode) {
+  benchmark_decode_corpus(typeid(*this).name(), geo_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_geo_decode_padded) {
+  benchmark_decode_padded_corpus(typeid(*this).name(), geo_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_nested_decode) {
+  benchmark_decode_corpus(typeid(*this).name(), nested_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_nested_decode_padded) {
+  benchmark_decode_padded_corpus(typeid(*this).name(), nested_corpus(), 50);
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_tweets_encode) {
+  benchmark_encode_corpus(typeid(*this).name(), tweets_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_catalog_encode) {
+  benchmark_encode_corpus(typeid(*this).name(), catalog_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_geo_encode) {
+  benchmark_encode_corpus(typeid(*this).name(), geo_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_corpus_nested_encode) {
+  benchmark_encode_corpus(typeid(*this).name(), nested_corpus(), 50);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
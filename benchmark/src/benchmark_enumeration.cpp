@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/enumeration.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/encode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+const int num_country_codes = 250;
+
+std::string country_code(const int i) {
+  const char code[] = { char('A' + i / 26), char('A' + i % 26) };
+  return std::string(code, 2);
+}
+
+enumeration_t<int, string_t> country_codec() {
+  std::vector<std::pair<int, std::string>> mapping;
+  for (int i = 0; i < num_country_codes; i++) {
+    mapping.emplace_back(i, country_code(i));
+  }
+  return enumeration_t<int, string_t>(string(), std::move(mapping));
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_enumeration_decode_large_enumeration) {
+  const auto codec = country_codec();
+  std::string json;
+  for (int i = 0; i < num_country_codes; i++) {
+    json += "\"" + country_code(i) + "\"";
+  }
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  JSON_BENCHMARK(1e4, [=]{
+    auto context = decode_context(json_begin, json_end);
+    for (int i = 0; i < num_country_codes; i++) {
+      codec.decode(context);
+    }
+  });
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_enumeration_encode_large_enumeration) {
+  const auto codec = country_codec();
+  JSON_BENCHMARK(1e4, [&]{
+    encode_context context;
+    for (int i = 0; i < num_country_codes; i++) {
+      codec.encode(context, i);
+    }
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
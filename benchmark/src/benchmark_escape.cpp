@@ -44,6 +44,38 @@ std::string generate_string(size_t size, bool add_special_characters) {
   return string;
 }
 
+/**
+ * Generate a string where the given percentage of the characters need to be
+ * escaped, spread out evenly. The escaped characters are mostly newlines and
+ * quotes, as in user-generated text.
+ */
+std::string generate_string_with_escape_density(size_t size, size_t percent) {
+  static const char SPECIAL_CHARACTERS[] = { '\n', '"', '\n', '"', '\\', '\t', 0x01 };
+  std::string string;
+  size_t num_special = 0;
+  for (size_t i = 0; i < size; i++) {
+    if ((i * percent) % 100 < percent) {
+      string += SPECIAL_CHARACTERS[num_special++ % sizeof(SPECIAL_CHARACTERS)];
+    } else {
+      string += char('a' + (i % 26));
+    }
+  }
+  return string;
+}
+
+void benchmark_escape_density(const char *name, size_t percent, bool use_sse42) {
+  const auto input = generate_string_with_escape_density(8192, percent);
+  const auto begin = input.data();
+
+  volatile size_t n = 0;
+  benchmark_throughput(name, 1e5, input.size(), 1, [&] {
+    encode_context context;
+    *const_cast<bool *>(&context.has_sse42) &= use_sse42;
+    write_escaped(context, begin, begin + input.size());
+    n += context.size();
+  });
+}
+
 void check_escaped(const std::string &expected, const std::string &input) {
   encode_context context;
   write_escaped(context, input.data(), input.data() + input.size());
@@ -109,6 +141,46 @@ BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_complex_string_sse42) {
 
 #endif  // defined(json_arch_x86_sse42)
 
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_1_percent) {
+  benchmark_escape_density(typeid(*this).name(), 1, false);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_5_percent) {
+  benchmark_escape_density(typeid(*this).name(), 5, false);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_20_percent) {
+  benchmark_escape_density(typeid(*this).name(), 20, false);
+}
+
+#if defined(json_arch_x86_sse42)
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_0_percent_sse42) {
+  benchmark_escape_density(typeid(*this).name(), 0, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_1_percent_sse42) {
+  benchmark_escape_density(typeid(*this).name(), 1, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_2_percent_sse42) {
+  benchmark_escape_density(typeid(*this).name(), 2, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_5_percent_sse42) {
+  benchmark_escape_density(typeid(*this).name(), 5, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_10_percent_sse42) {
+  benchmark_escape_density(typeid(*this).name(), 10, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_detail_write_escaped_density_20_percent_sse42) {
+  benchmark_escape_density(typeid(*this).name(), 20, true);
+}
+
+#endif  // defined(json_arch_x86_sse42)
+
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
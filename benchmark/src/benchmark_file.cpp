@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_file.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+/*
+ * The file benchmarks compare decoding a file that is read into a string with
+ * decoding it straight from a memory mapping with decode_file.
+ */
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+using catalog_entry_t = std::map<std::string, std::string>;
+using catalog_t = std::vector<catalog_entry_t>;
+
+/**
+ * A catalog snapshot of about 8 MB, written to the temporary directory and
+ * removed again when the benchmark is done.
+ */
+struct catalog_file {
+  catalog_file()
+      : path((std::filesystem::temp_directory_path() / "spotify_json_benchmark_catalog.json").string()) {
+    catalog_t catalog;
+    for (int i = 0; i < 40000; i++) {
+      const auto id = std::to_string(i);
+      catalog.push_back({
+          { "id", "spotify:track:" + id },
+          { "name", "Track number " + id + " of the catalog snapshot" },
+          { "album", "Album " + std::to_string(i / 12) },
+          { "artist", "Artist " + std::to_string(i / 120) } });
+    }
+    const auto json = encode(catalog);
+    std::ofstream(path, std::ios::binary) << json;
+    size = json.size();
+  }
+
+  ~catalog_file() {
+    std::error_code error;
+    std::filesystem::remove(path, error);
+  }
+
+  std::string path;
+  size_t size = 0;
+};
+
+std::string read_file(const std::string &path) {
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_file_decode_read_into_string) {
+  const catalog_file file;
+  benchmark_throughput(typeid(*this).name(), 20, file.size, 1, [&]{
+    const auto catalog = decode<catalog_t>(read_file(file.path));
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_file_decode_file) {
+  const catalog_file file;
+  benchmark_throughput(typeid(*this).name(), 20, file.size, 1, [&]{
+    const auto catalog = decode_file<catalog_t>(file.path);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
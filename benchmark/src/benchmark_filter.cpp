@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/filter.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct user_t {
+  std::string id;
+  std::string name;
+  std::string status;
+  int age = 0;
+};
+
+object_t<user_t> user_codec() {
+  auto codec = object<user_t>();
+  codec.required("id", &user_t::id);
+  codec.required("name", &user_t::name);
+  codec.required("status", &user_t::status);
+  codec.required("age", &user_t::age);
+  return codec;
+}
+
+auto is_active() {
+  return where("status", string(), [](const std::string &status) { return status == "active"; });
+}
+
+/**
+ * An array of users where every tenth user is active.
+ */
+std::string generate_user_array_json(size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? "," : "");
+    json += "{\"id\":\"spotify:user:" + std::to_string(i) + "\",";
+    json += "\"name\":\"A user name that does not fit in a small string\",";
+    json += "\"status\":\"" + std::string(i % 10 ? "inactive" : "active") + "\",";
+    json += "\"age\":" + std::to_string(i % 100) + "}";
+  }
+  return json + "]";
+}
+
+template <typename codec_type>
+void benchmark_decode(const char *name, const codec_type &codec, const std::string &json, size_t runs) {
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  benchmark(name, runs, [&]{
+    auto context = decode_context(json_begin, json_end);
+    codec.decode(context);
+  });
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_filter_decode_all_then_filter) {
+  const auto codec = array<std::vector<user_t>>(user_codec());
+  const auto json = generate_user_array_json(100000);
+  benchmark(typeid(*this).name(), 20, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    auto users = codec.decode(context);
+    users.erase(
+        std::remove_if(users.begin(), users.end(), [](const user_t &user) { return user.status != "active"; }),
+        users.end());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_filter_decode_filtered_array) {
+  const auto codec = filtered_array<std::vector<user_t>>(user_codec(), is_active());
+  benchmark_decode(typeid(*this).name(), codec, generate_user_array_json(100000), 20);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_filter_decode_count_array) {
+  const auto codec = count_array(is_active());
+  benchmark_decode(typeid(*this).name(), codec, generate_user_array_json(100000), 20);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_filter_decode_sum_array) {
+  const auto codec = sum_array<long long>("age", is_active());
+  benchmark_decode(typeid(*this).name(), codec, generate_user_array_json(100000), 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/any_codec.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/frozen.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+/*
+ * The frozen benchmarks compare threads that copy a codec for every request,
+ * which copies the shared_ptrs inside the object_t codecs and makes the
+ * threads contend for their reference counts, with threads that share one
+ * frozen codec through frozen_ref_t.
+ */
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct frozen_artist_t {
+  std::string id;
+  std::string name;
+};
+
+struct frozen_track_t {
+  std::string id;
+  std::string title;
+  int duration = 0;
+  std::vector<frozen_artist_t> artists;
+};
+
+codec::object_t<frozen_track_t> make_frozen_track_codec() {
+  auto artist_codec = codec::object<frozen_artist_t>();
+  artist_codec.required("id", &frozen_artist_t::id);
+  artist_codec.required("name", &frozen_artist_t::name);
+
+  auto codec = codec::object<frozen_track_t>();
+  codec.required("id", &frozen_track_t::id);
+  codec.required("title", &frozen_track_t::title);
+  codec.optional("duration", &frozen_track_t::duration, codec::any_codec(codec::number<int>()));
+  codec.required("artists", &frozen_track_t::artists, codec::array<std::vector<frozen_artist_t>>(artist_codec));
+  return codec;
+}
+
+const std::string FROZEN_TRACK_JSON =
+    R"({"id":"t1","title":"Song","duration":180,"artists":[{"id":"a1","name":"Artist"}]})";
+
+constexpr size_t FROZEN_REQUESTS_PER_THREAD = 20000;
+
+/**
+ * Runs the request function FROZEN_REQUESTS_PER_THREAD times on each of the
+ * threads, and waits for all of them.
+ */
+template <typename request_fn>
+void run_on_threads(const size_t num_threads, const request_fn &request) {
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&] {
+      for (size_t n = 0; n < FROZEN_REQUESTS_PER_THREAD; n++) {
+        request();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+void benchmark_copied_codec(const char *name, const size_t num_threads) {
+  const auto shared = make_frozen_track_codec();
+  const auto bytes = FROZEN_TRACK_JSON.size() * FROZEN_REQUESTS_PER_THREAD * num_threads;
+  benchmark_throughput(name, 5, bytes, FROZEN_REQUESTS_PER_THREAD * num_threads, [&]{
+    run_on_threads(num_threads, [&] {
+      const auto codec = shared;
+      decode(codec, FROZEN_TRACK_JSON);
+    });
+  });
+}
+
+void benchmark_frozen_codec(const char *name, const size_t num_threads) {
+  const auto frozen = codec::freeze(make_frozen_track_codec());
+  const auto bytes = FROZEN_TRACK_JSON.size() * FROZEN_REQUESTS_PER_THREAD * num_threads;
+  benchmark_throughput(name, 5, bytes, FROZEN_REQUESTS_PER_THREAD * num_threads, [&]{
+    run_on_threads(num_threads, [&] {
+      const auto codec = frozen.ref();
+      decode(codec, FROZEN_TRACK_JSON);
+    });
+  });
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_frozen_copied_codec_1_thread) {
+  benchmark_copied_codec(typeid(*this).name(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_frozen_copied_codec_4_threads) {
+  benchmark_copied_codec(typeid(*this).name(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_frozen_copied_codec_16_threads) {
+  benchmark_copied_codec(typeid(*this).name(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_frozen_frozen_codec_1_thread) {
+  benchmark_frozen_codec(typeid(*this).name(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_frozen_frozen_codec_4_threads) {
+  benchmark_frozen_codec(typeid(*this).name(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_frozen_frozen_codec_16_threads) {
+  benchmark_frozen_codec(typeid(*this).name(), 16);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
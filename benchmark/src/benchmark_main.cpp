@@ -16,4 +16,107 @@
 
 #define BOOST_TEST_MODULE json_benchmark
 
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
 #include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+namespace spotify {
+namespace json {
+
+template <>
+struct default_codec_t<benchmark_result> {
+  static codec::object_t<benchmark_result> codec() {
+    codec::object_t<benchmark_result> codec;
+    codec.required("name", &benchmark_result::name);
+    codec.required("runs", &benchmark_result::runs);
+    codec.required("total_ms", &benchmark_result::total_ms);
+    codec.required("us_avg", &benchmark_result::us_avg);
+    codec.required("bytes_per_run", &benchmark_result::bytes_per_run);
+    codec.required("documents_per_run", &benchmark_result::documents_per_run);
+    codec.required("mb_per_s",
+        [](const benchmark_result &result) { return result.megabytes_per_second(); },
+        [](benchmark_result & /*result*/, double /*value*/) {});
+    codec.required("documents_per_s",
+        [](const benchmark_result &result) { return result.documents_per_second(); },
+        [](benchmark_result & /*result*/, double /*value*/) {});
+    codec.required("allocations_per_run", &benchmark_result::allocations_per_run);
+    codec.required("bytes_allocated_per_run", &benchmark_result::bytes_allocated_per_run);
+    codec.required("peak_live_bytes", &benchmark_result::peak_live_bytes);
+    codec.optional("counters", &benchmark_result::counters);
+    return codec;
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
+
+namespace {
+
+void write_csv(std::ostream &stream, const std::vector<benchmark_result> &results) {
+  stream << "name,runs,total_ms,us_avg,bytes_per_run,documents_per_run,mb_per_s,documents_per_s";
+  stream << ",allocations_per_run,bytes_allocated_per_run,peak_live_bytes";
+  for (size_t i = 0; i < perf_counters::num_counters; i++) {
+    stream << ',' << perf_counters::name(perf_counters::counter(i));
+  }
+  stream << '\n';
+
+  for (const auto &result : results) {
+    stream
+        << spotify::json::encode(result.name) << ','
+        << result.runs << ','
+        << result.total_ms << ','
+        << result.us_avg << ','
+        << result.bytes_per_run << ','
+        << result.documents_per_run << ','
+        << result.megabytes_per_second() << ','
+        << result.documents_per_second() << ','
+        << result.allocations_per_run << ','
+        << result.bytes_allocated_per_run << ','
+        << result.peak_live_bytes;
+    for (size_t i = 0; i < perf_counters::num_counters; i++) {
+      const auto counter = result.counters.find(perf_counters::name(perf_counters::counter(i)));
+      stream << ',';
+      if (counter != result.counters.end()) {
+        stream << counter->second;
+      }
+    }
+    stream << '\n';
+  }
+}
+
+/**
+ * When the SPOTIFY_JSON_BENCHMARK_RESULTS environment variable is set, the
+ * results of all benchmarks that ran are written to the file it names when the
+ * run is over, as CSV if the file name ends with .csv and as JSON otherwise.
+ */
+struct benchmark_results_writer {
+  ~benchmark_results_writer() {
+    const auto path = std::getenv("SPOTIFY_JSON_BENCHMARK_RESULTS");
+    if (!path) {
+      return;
+    }
+
+    const auto file_name = std::string(path);
+    std::ofstream stream(file_name);
+    if (file_name.size() >= 4 && file_name.compare(file_name.size() - 4, 4, ".csv") == 0) {
+      write_csv(stream, benchmark_results());
+    } else {
+      stream << spotify::json::encode(benchmark_results()) << '\n';
+    }
+  }
+};
+
+}  // namespace
+
+BOOST_TEST_GLOBAL_FIXTURE(benchmark_results_writer);
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include <boost/container/flat_map.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/boost.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/decode_context.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+/**
+ * A JSON object with 'size' integer fields, with keys in pseudo-random order.
+ */
+std::string generate_map_json(size_t size) {
+  std::string json = "{";
+  for (size_t i = 0; i < size; i++) {
+    const auto key = (i * 7919) % size;
+    json += (i ? ",\"key_" : "\"key_") + std::to_string(key) + "\":" + std::to_string(i);
+  }
+  return json + "}";
+}
+
+template <typename map_type>
+void benchmark_decode_map(const char *name, size_t size, size_t runs) {
+  const auto codec = default_codec<map_type>();
+  const auto json = generate_map_json(size);
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  benchmark(name, runs, [=]{
+    auto context = decode_context(json_begin, json_end);
+    codec.decode(context);
+  });
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_map_decode_large_map) {
+  benchmark_decode_map<std::map<std::string, int>>(typeid(*this).name(), 10000, 100);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_map_decode_large_unordered_map) {
+  benchmark_decode_map<std::unordered_map<std::string, int>>(typeid(*this).name(), 10000, 100);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_map_decode_large_flat_map) {
+  benchmark_decode_map<boost::container::flat_map<std::string, int>>(typeid(*this).name(), 10000, 100);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_map_decode_small_flat_map) {
+  benchmark_decode_map<boost::container::flat_map<std::string, int>>(typeid(*this).name(), 10, 1e5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
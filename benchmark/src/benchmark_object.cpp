@@ -15,11 +15,13 @@
  */
 
 #include <string>
+#include <vector>
 
 #include <sstream>
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/array.hpp>
 #include <spotify/json/codec/object.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
@@ -84,6 +86,93 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_with_many_required_field
   });
 }
 
+struct playlist_t {
+  std::string name;
+  std::string description;
+  std::vector<std::string> tracks;
+};
+
+codec::object_t<playlist_t> playlist_codec() {
+  auto codec = codec::object<playlist_t>();
+  codec.required("name", &playlist_t::name);
+  codec.required("description", &playlist_t::description);
+  codec.required("tracks", &playlist_t::tracks);
+  return codec;
+}
+
+std::string make_playlist_json(size_t n) {
+  std::stringstream json_ss;
+  json_ss << R"({"name":"A playlist name that does not fit in a small string",)";
+  json_ss << R"("description":"A description that does not fit in a small string either",)";
+  json_ss << R"("tracks":[)";
+  for (size_t i = 0; i < n; i++) {
+    json_ss << (i ? "," : "") << "\"spotify:track:" << i << '"';
+  }
+  json_ss << "]}";
+  return json_ss.str();
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_playlist) {
+  const auto codec = playlist_codec();
+  const auto json = make_playlist_json(100);
+
+  JSON_BENCHMARK(1e5, [=]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_into_playlist) {
+  const auto codec = playlist_codec();
+  const auto json = make_playlist_json(100);
+  playlist_t playlist;
+
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode_into(context, playlist);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_decode_projected_playlist) {
+  const auto codec = playlist_codec();
+  const auto projection = codec.projection({ "name" });
+  const auto json = make_playlist_json(100);
+
+  JSON_BENCHMARK(1e5, [&]{
+    auto context = decode_context(json.data(), json.data() + json.size());
+    codec.decode(context, projection);
+  });
+}
+
+struct playlist_passthrough_t {
+  std::string name;
+  unknown_fields unknown;
+};
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_rename_playlist) {
+  const auto codec = playlist_codec();
+  const auto json = make_playlist_json(100);
+
+  JSON_BENCHMARK(1e5, [&]{
+    auto playlist = decode(codec, json);
+    playlist.name = "Renamed";
+    encode(codec, playlist);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_object_rename_playlist_with_unknown_fields) {
+  auto codec = codec::object<playlist_passthrough_t>();
+  codec.required("name", &playlist_passthrough_t::name);
+  codec.capture_unknown_fields(&playlist_passthrough_t::unknown);
+  const auto json = make_playlist_json(100);
+
+  JSON_BENCHMARK(1e5, [&]{
+    auto playlist = decode(codec, json);
+    playlist.name = "Renamed";
+    encode(codec, playlist);
+  });
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
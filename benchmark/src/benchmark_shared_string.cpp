@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/shared_string.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+
+/*
+ * The shared string benchmarks decode the same tracks into std::string fields
+ * and into shared_string fields with decode_shared. The allocation counts
+ * show the memory that decoded strings take on top of the input.
+ */
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+template <typename string_type>
+struct shared_track_t {
+  string_type uri;
+  string_type name;
+  string_type album;
+  int duration = 0;
+};
+
+template <typename string_type>
+codec::array_t<std::vector<shared_track_t<string_type>>, codec::object_t<shared_track_t<string_type>>>
+shared_tracks_codec() {
+  using track_type = shared_track_t<string_type>;
+  auto codec = codec::object<track_type>();
+  codec.required("uri", &track_type::uri);
+  codec.required("name", &track_type::name);
+  codec.required("album", &track_type::album);
+  codec.required("duration", &track_type::duration);
+  return codec::array<std::vector<track_type>>(codec);
+}
+
+std::string generate_tracks_json(const size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    json += (i ? "," : "");
+    json += R"({"uri":"spotify:track:)" + std::to_string(1000000 + i) + R"(",)";
+    json += R"("name":"A track name that does not fit in a small string",)";
+    json += R"("album":"An album name that does not fit in a small string either",)";
+    json += R"("duration":)" + std::to_string(i) + "}";
+  }
+  return json + "]";
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_shared_string_decode_std_string) {
+  const auto codec = shared_tracks_codec<std::string>();
+  const auto json = generate_tracks_json(1000);
+  JSON_BENCHMARK(1e3, [&] {
+    decode(codec, json);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_shared_string_decode_shared_string) {
+  const auto codec = shared_tracks_codec<shared_string>();
+  const auto json = std::make_shared<const std::string>(generate_tracks_json(1000));
+  JSON_BENCHMARK(1e3, [&] {
+    decode_shared(codec, json);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/static_object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+
+#include <spotify/json/benchmark/allocation_counters.hpp>
+#include <spotify/json/benchmark/benchmark.hpp>
+
+/*
+ * The startup benchmarks measure what it costs to build the codecs of a
+ * service and decode its first request with them, and compare object_t, which
+ * allocates and escapes its fields at runtime, with static_object_t, which does
+ * both at compile time.
+ */
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct startup_track_t {
+  std::string id;
+  std::string title;
+  std::string album;
+  int duration = 0;
+  int popularity = 0;
+  bool explicit_lyrics = false;
+};
+
+codec::object_t<startup_track_t> make_startup_object_codec() {
+  auto codec = codec::object<startup_track_t>();
+  codec.required("id", &startup_track_t::id);
+  codec.required("title", &startup_track_t::title);
+  codec.optional("album", &startup_track_t::album);
+  codec.optional("duration", &startup_track_t::duration);
+  codec.optional("popularity", &startup_track_t::popularity);
+  codec.optional("explicit", &startup_track_t::explicit_lyrics);
+  return codec;
+}
+
+constexpr auto STARTUP_STATIC_CODEC = codec::static_object<startup_track_t>(
+    codec::static_required("id", &startup_track_t::id),
+    codec::static_required("title", &startup_track_t::title),
+    codec::static_optional("album", &startup_track_t::album),
+    codec::static_optional("duration", &startup_track_t::duration),
+    codec::static_optional("popularity", &startup_track_t::popularity),
+    codec::static_optional("explicit", &startup_track_t::explicit_lyrics));
+
+const std::string STARTUP_TRACK_JSON =
+    R"({"id":"t1","title":"Song","album":"Album","duration":180,"popularity":52,"explicit":false})";
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_startup_build_object_codec) {
+  JSON_BENCHMARK(1e5, [] {
+    const auto codec = make_startup_object_codec();
+    decode(codec, STARTUP_TRACK_JSON);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_startup_build_static_object_codec) {
+  JSON_BENCHMARK(1e5, [] {
+    const auto codec = STARTUP_STATIC_CODEC;
+    decode(codec, STARTUP_TRACK_JSON);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_startup_allocations) {
+  if (!allocation_counter::available()) {
+    BOOST_TEST_MESSAGE("allocation counting is not available");
+    return;
+  }
+
+  const allocation_counter object_counter;
+  const auto object_codec = make_startup_object_codec();
+  const auto object_counts = object_counter.stop();
+
+  const allocation_counter static_counter;
+  const auto static_codec = STARTUP_STATIC_CODEC;
+  const auto static_counts = static_counter.stop();
+
+  BOOST_TEST_MESSAGE(
+      "object_t: " << object_counts.allocations << " allocations, " <<
+      object_counts.bytes_allocated << " bytes; static_object_t: " <<
+      static_counts.allocations << " allocations, " <<
+      static_counts.bytes_allocated << " bytes");
+  BOOST_CHECK_EQUAL(static_counts.allocations, 0);
+  BOOST_CHECK(decode(object_codec, STARTUP_TRACK_JSON).id == decode(static_codec, STARTUP_TRACK_JSON).id);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_decode_startup_object_codec) {
+  const auto codec = make_startup_object_codec();
+  JSON_BENCHMARK(1e5, [&] {
+    decode(codec, STARTUP_TRACK_JSON);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_decode_startup_static_object_codec) {
+  JSON_BENCHMARK(1e5, [&] {
+    decode(STARTUP_STATIC_CODEC, STARTUP_TRACK_JSON);
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
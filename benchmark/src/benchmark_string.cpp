@@ -48,6 +48,57 @@ std::string generate_simple_json_string(size_t size) {
   return "\"" + generate_simple_string(size) + "\"";
 }
 
+std::string generate_utf8_string(size_t size) {
+  std::string string;
+  string.reserve(size);
+  for (size_t i = 0; string.size() < size; i++) {
+    string += (i % 2 ? "\xC3\xA5" : "\xE2\x98\x83");
+    string += generate_simple_string(i % 8);
+  }
+  return string;
+}
+
+std::string generate_emoji_json_string(size_t size) {
+  static const char *EMOJI[] = { "\\ud83d\\ude00", "\\ud83c\\udfb5", "\\u2764", "\\ud83d\\udc95" };
+  std::string json = "\"";
+  for (size_t i = 0; json.size() < size; i++) {
+    json += EMOJI[i % 4];
+    json += generate_simple_string(i % 6);
+  }
+  return json + "\"";
+}
+
+std::string generate_json_in_json_string(size_t size) {
+  std::string inner = "[";
+  for (size_t i = 0; inner.size() < size * 4 / 5; i++) {
+    inner += "{\"id\":" + std::to_string(i) + ",\"name\":\"track " + std::to_string(i) + "\",";
+    inner += "\"path\":\"C:\\\\music\\\\" + std::to_string(i) + "\"},\n";
+  }
+  inner += "]";
+  return encode(inner);
+}
+
+template <typename codec_type>
+void benchmark_decode_long_string(const char *name, const codec_type &codec, const std::string &json, bool validate_utf8) {
+  const auto json_begin = json.data();
+  const auto json_end = json.data() + json.size();
+  benchmark_throughput(name, 1e5, json.size(), 1, [&]{
+    auto context = decode_context(json_begin, json_end);
+    context.validate_utf8 = validate_utf8;
+    const auto decoded_string = codec.decode(context);
+  });
+}
+
+template <typename codec_type>
+void benchmark_encode_long_string(const char *name, const codec_type &codec, const std::string &string, bool validate_utf8) {
+  auto context = encode_context(string.size() + 2);
+  context.validate_utf8 = validate_utf8;
+  benchmark_throughput(name, 1e5, string.size(), 1, [&]{
+    codec.encode(context, string);
+    context.clear();
+  });
+}
+
 /*
  * Decoding
  */
@@ -76,6 +127,31 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_simple_tiny_string) {
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_simple_long_string_validate_utf8) {
+  const auto json = generate_simple_json_string(10000);
+  benchmark_decode_long_string(typeid(*this).name(), default_codec<std::string>(), json, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_utf8_long_string) {
+  const auto json = "\"" + generate_utf8_string(10000) + "\"";
+  benchmark_decode_long_string(typeid(*this).name(), default_codec<std::string>(), json, false);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_utf8_long_string_validate_utf8) {
+  const auto json = "\"" + generate_utf8_string(10000) + "\"";
+  benchmark_decode_long_string(typeid(*this).name(), default_codec<std::string>(), json, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_emoji_long_string) {
+  const auto json = generate_emoji_json_string(10000);
+  benchmark_decode_long_string(typeid(*this).name(), default_codec<std::string>(), json, false);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_decode_json_in_json_long_string) {
+  const auto json = generate_json_in_json_string(10000);
+  benchmark_decode_long_string(typeid(*this).name(), default_codec<std::string>(), json, false);
+}
+
 /*
  * Encoding
  */
@@ -102,6 +178,21 @@ BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_simple_tiny_string) {
   });
 }
 
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_simple_long_string_validate_utf8) {
+  const auto string = generate_simple_string(10000);
+  benchmark_encode_long_string(typeid(*this).name(), default_codec<std::string>(), string, true);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_utf8_long_string) {
+  const auto string = generate_utf8_string(10000);
+  benchmark_encode_long_string(typeid(*this).name(), default_codec<std::string>(), string, false);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_codec_string_encode_utf8_long_string_validate_utf8) {
+  const auto string = generate_utf8_string(10000);
+  benchmark_encode_long_string(typeid(*this).name(), default_codec<std::string>(), string, true);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+#include <spotify/json/benchmark/benchmark.hpp>
+#include <spotify/json/benchmark/workload.hpp>
+
+/*
+ * The workload benchmarks sweep one parameter of a synthetic workload at a
+ * time, keeping the others at their defaults, to find where decoding and
+ * encoding fall off a cliff.
+ */
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+const size_t WORKLOAD_BYTES = 256 * 1024;
+const size_t WORKLOAD_RUNS = 20;
+
+/**
+ * Decode and encode a workload document of about WORKLOAD_BYTES bytes, with as
+ * many records as it takes to get there.
+ */
+void benchmark_workload(const std::string &name, workload_options options) {
+  options.records = 8;
+  const auto sample_size = generate_workload(options).size();
+  options.records = std::max(size_t(1), 8 * WORKLOAD_BYTES / sample_size);
+
+  const auto json = generate_workload(options);
+  const auto codec = codec::array<std::vector<workload_record>>(workload_codec(options));
+
+  benchmark_throughput((name + "_decode").c_str(), WORKLOAD_RUNS, json.size(), 1, [&]{
+    auto context = decode_context(json.data(), json.size());
+    const auto records = codec.decode(context);
+  });
+
+  const auto records = decode(codec, json);
+  const auto encoded_size = encode(codec, records).size();
+  encode_context context;
+  benchmark_throughput((name + "_encode").c_str(), WORKLOAD_RUNS, encoded_size, 1, [&]{
+    codec.encode(context, records);
+    context.clear();
+  });
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_depth) {
+  for (const auto depth : { 1, 2, 4, 8, 16, 64 }) {
+    workload_options options;
+    options.depth = depth;
+    benchmark_workload("workload_depth_" + std::to_string(depth), options);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_width) {
+  for (const auto width : { 1, 4, 16, 64, 256 }) {
+    workload_options options;
+    options.width = width;
+    benchmark_workload("workload_width_" + std::to_string(width), options);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_string_length) {
+  for (const auto length : { 4, 16, 64, 256, 1024 }) {
+    workload_options options;
+    options.string_fields = 1;
+    options.min_string_length = length / 2;
+    options.max_string_length = length;
+    benchmark_workload("workload_string_length_" + std::to_string(length), options);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_escape_density) {
+  for (const auto percent : { 0, 1, 5, 20 }) {
+    workload_options options;
+    options.string_fields = 1;
+    options.min_string_length = 32;
+    options.max_string_length = 128;
+    options.escape_density = percent / 100.0;
+    benchmark_workload("workload_escape_density_" + std::to_string(percent), options);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_non_ascii_ratio) {
+  for (const auto percent : { 0, 10, 50, 100 }) {
+    workload_options options;
+    options.string_fields = 1;
+    options.min_string_length = 32;
+    options.max_string_length = 128;
+    options.non_ascii_ratio = percent / 100.0;
+    benchmark_workload("workload_non_ascii_ratio_" + std::to_string(percent), options);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_numbers) {
+  using number_kind = workload_options::number_kind;
+  const std::pair<number_kind, const char *> kinds[] = {
+    { number_kind::small_integers, "small_integers" },
+    { number_kind::large_integers, "large_integers" },
+    { number_kind::decimals, "decimals" },
+    { number_kind::doubles, "doubles" },
+    { number_kind::mixed, "mixed" }
+  };
+
+  for (const auto &kind : kinds) {
+    workload_options options;
+    options.string_fields = 0;
+    options.numbers = kind.first;
+    benchmark_workload(std::string("workload_numbers_") + kind.second, options);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_whitespace) {
+  using whitespace_style = workload_options::whitespace_style;
+  const std::pair<whitespace_style, const char *> styles[] = {
+    { whitespace_style::compact, "compact" },
+    { whitespace_style::spaced, "spaced" },
+    { whitespace_style::pretty, "pretty" }
+  };
+
+  for (const auto &style : styles) {
+    workload_options options;
+    options.depth = 4;
+    options.whitespace = style.first;
+    benchmark_workload(std::string("workload_whitespace_") + style.second, options);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_json_workload_unknown_fields) {
+  for (const auto percent : { 0, 25, 50, 75 }) {
+    workload_options options;
+    options.unknown_fields = percent / 100.0;
+    benchmark_workload("workload_unknown_fields_" + std::to_string(percent), options);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -17,7 +17,10 @@
 #pragma once
 
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
+
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
@@ -27,65 +30,163 @@ namespace spotify {
 namespace json {
 namespace codec {
 
+/**
+ * A codec that erases the type of another codec. Codecs that fit in
+ * inline_size bytes and can be moved without throwing, which covers most codecs
+ * apart from object_t, are stored in place; larger codecs are allocated once
+ * and shared between copies. Calls are dispatched through a static table of
+ * function pointers, so each call is a single indirect call.
+ */
 template <typename T>
 class any_codec_t final {
  public:
   using object_type = T;
 
-  template <typename codec_type>
+  static constexpr size_t inline_size = 3 * sizeof(void *);
+
+  template <
+      typename codec_type,
+      typename = typename std::enable_if<
+          !std::is_same<typename std::decay<codec_type>::type, any_codec_t>::value>::type>
   explicit any_codec_t(codec_type &&codec)
-      : _codec(std::make_shared<erased_codec_impl<codec_type>>(std::forward<codec_type>(codec))) {}
+      : _vtable(&erased_codec<typename std::decay<codec_type>::type>::vtable) {
+    erased_codec<typename std::decay<codec_type>::type>::construct(
+        _storage, std::forward<codec_type>(codec));
+  }
+
+  any_codec_t(const any_codec_t &other)
+      : _vtable(other._vtable) {
+    _vtable->copy(other._storage, _storage);
+  }
+
+  any_codec_t(any_codec_t &&other) noexcept
+      : _vtable(other._vtable) {
+    _vtable->move(other._storage, _storage);
+  }
+
+  ~any_codec_t() {
+    _vtable->destroy(_storage);
+  }
+
+  any_codec_t &operator=(const any_codec_t &other) {
+    if (this != &other) {
+      *this = any_codec_t(other);
+    }
+    return *this;
+  }
+
+  any_codec_t &operator=(any_codec_t &&other) noexcept {
+    if (this != &other) {
+      _vtable->destroy(_storage);
+      _vtable = other._vtable;
+      _vtable->move(other._storage, _storage);
+    }
+    return *this;
+  }
 
   object_type decode(decode_context &context) const {
-    return _codec->decode(context);
+    return _vtable->decode(_storage, context);
   }
 
   void encode(encode_context &context, const object_type &value) const {
-    _codec->encode(context, value);
+    _vtable->encode(_storage, context, value);
   }
 
   bool should_encode(const object_type &value) const {
-    return _codec->should_encode(value);
+    return _vtable->should_encode(_storage, value);
   }
 
- private:
-  class erased_codec {
-   public:
-    virtual ~erased_codec() = default;
+  detail::token_mask accepted_tokens() const {
+    return _vtable->accepted_tokens(_storage);
+  }
 
-    virtual object_type decode(decode_context &context) const = 0;
-    virtual void encode(encode_context &context, const object_type &value) const = 0;
-    virtual bool should_encode(const object_type &value) const = 0;
+ private:
+  struct erased_vtable {
+    object_type (*decode)(const void *storage, decode_context &context);
+    void (*encode)(const void *storage, encode_context &context, const object_type &value);
+    bool (*should_encode)(const void *storage, const object_type &value);
+    detail::token_mask (*accepted_tokens)(const void *storage);
+    void (*copy)(const void *from, void *to);
+    void (*move)(void *from, void *to) noexcept;
+    void (*destroy)(void *storage) noexcept;
   };
 
   template <typename codec_type>
-  class erased_codec_impl final : public erased_codec {
-   public:
-    explicit erased_codec_impl(codec_type &&codec) : _codec(std::move(codec)) {}
-    explicit erased_codec_impl(const codec_type &codec) : _codec(codec) {}
+  static constexpr bool is_stored_inline =
+      sizeof(codec_type) <= inline_size &&
+      alignof(codec_type) <= alignof(void *) &&
+      std::is_nothrow_move_constructible<codec_type>::value;
+
+  /**
+   * The storage is either the codec itself or a shared_ptr to it, which
+   * always fits inline.
+   */
+  template <typename codec_type>
+  struct erased_codec {
+    using stored_type = typename std::conditional<
+        is_stored_inline<codec_type>,
+        codec_type,
+        std::shared_ptr<const codec_type>>::type;
+
+    static_assert(sizeof(stored_type) <= inline_size, "the stored codec must fit inline");
+
+    template <typename arg_type>
+    static void construct(void *storage, arg_type &&codec) {
+      if constexpr (is_stored_inline<codec_type>) {
+        new (storage) stored_type(std::forward<arg_type>(codec));
+      } else {
+        new (storage) stored_type(std::make_shared<const codec_type>(std::forward<arg_type>(codec)));
+      }
+    }
+
+    static const codec_type &get(const void *storage) {
+      if constexpr (is_stored_inline<codec_type>) {
+        return *static_cast<const stored_type *>(storage);
+      } else {
+        return **static_cast<const stored_type *>(storage);
+      }
+    }
+
+    static object_type decode(const void *storage, decode_context &context) {
+      return get(storage).decode(context);
+    }
+
+    static void encode(const void *storage, encode_context &context, const object_type &value) {
+      get(storage).encode(context, value);
+    }
+
+    static bool should_encode(const void *storage, const object_type &value) {
+      return detail::should_encode(get(storage), value);
+    }
+
+    static detail::token_mask accepted_tokens(const void *storage) {
+      return detail::accepted_tokens(get(storage));
+    }
 
-    object_type decode(decode_context &context) const override {
-      return _codec.decode(context);
+    static void copy(const void *from, void *to) {
+      new (to) stored_type(*static_cast<const stored_type *>(from));
     }
 
-    void encode(encode_context &context, const object_type &value) const override {
-      _codec.encode(context, value);
+    static void move(void *from, void *to) noexcept {
+      new (to) stored_type(std::move(*static_cast<stored_type *>(from)));
     }
 
-    bool should_encode(const object_type &value) const override {
-      return detail::should_encode(_codec, value);
+    static void destroy(void *storage) noexcept {
+      static_cast<stored_type *>(storage)->~stored_type();
     }
 
-   private:
-    const codec_type _codec;
+    static constexpr erased_vtable vtable = {
+      &decode, &encode, &should_encode, &accepted_tokens, &copy, &move, &destroy
+    };
   };
 
-  std::shared_ptr<const erased_codec> _codec;
+  const erased_vtable *_vtable;
+  alignas(void *) unsigned char _storage[inline_size];
 };
 
 template <typename codec_type>
-any_codec_t<typename codec_type::object_type> any_codec(codec_type &&codec) {
-  return any_codec_t<typename codec_type::object_type>(std::forward<codec_type>(codec));
+any_codec_t<typename std::decay<codec_type>::type::object_type> any_codec(codec_type &&codec) {
+  return any_codec_t<typename std::decay<codec_type>::type::object_type>(std::forward<codec_type>(codec));
 }
 
 }  // namespace codec
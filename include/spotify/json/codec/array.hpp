@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <deque>
 #include <list>
@@ -28,6 +29,7 @@
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/skip_value.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -37,6 +39,12 @@ namespace detail {
 struct sequence_inserter {
   using state = int;
   static const state init_state = 0;
+  static const bool can_reserve = false;
+
+  template <typename container_type>
+  static void reserve(container_type &, size_t) {
+    // Nothing to reserve
+  }
 
   template <typename container_type, typename value_type>
   static state insert(
@@ -52,11 +60,39 @@ struct sequence_inserter {
   static void validate(decode_context &, state, container_type &) {
     // Nothing to validate
   }
+
+  /**
+   * Decode into the elements that the container already has, append any
+   * elements beyond those and erase the ones that are left over.
+   */
+  template <typename container_type, typename codec_type>
+  static void decode_into(decode_context &context, container_type &container, const codec_type &codec) {
+    auto it = container.begin();
+    auto at_end = (it == container.end());
+    decode_comma_separated(context, '[', ']', [&]{
+      if (json_likely(!at_end)) {
+        auto &&element = *it;
+        detail::decode_into(codec, context, element);
+        at_end = (++it == container.end());
+      } else {
+        container.push_back(codec.decode(context));
+      }
+    });
+    if (!at_end) {
+      container.erase(it, container.end());
+    }
+  }
 };
 
 struct fixed_size_sequence_inserter {
   using state = size_t;
   static const state init_state = 0;
+  static const bool can_reserve = false;
+
+  template <typename container_type>
+  static void reserve(container_type &, size_t) {
+    // Nothing to reserve
+  }
 
   template <typename container_type, typename value_type>
   static state insert(
@@ -73,11 +109,27 @@ struct fixed_size_sequence_inserter {
   static void validate(decode_context &context, state pos, container_type &container) {
     fail_if(context, pos != container.size(), "Too few elements in array");
   }
+
+  template <typename container_type, typename codec_type>
+  static void decode_into(decode_context &context, container_type &container, const codec_type &codec) {
+    state pos = init_state;
+    decode_comma_separated(context, '[', ']', [&]{
+      fail_if(context, pos >= container.size(), "Too many elements in array");
+      detail::decode_into(codec, context, container[pos++]);
+    });
+    validate(context, pos, container);
+  }
 };
 
 struct associative_inserter {
   using state = int;
   static const state init_state = 0;
+  static const bool can_reserve = false;
+
+  template <typename container_type>
+  static void reserve(container_type &, size_t) {
+    // Nothing to reserve
+  }
 
   template <typename container_type, typename value_type>
   static state insert(
@@ -93,12 +145,53 @@ struct associative_inserter {
   static void validate(decode_context &, state, container_type &) {
     // Nothing to validate
   }
+
+  /**
+   * The elements of associative containers are const, so they cannot be
+   * decoded into. Clearing the container keeps the buckets of hash sets.
+   */
+  template <typename container_type, typename codec_type>
+  static void decode_into(decode_context &context, container_type &container, const codec_type &codec) {
+    container.clear();
+    decode_comma_separated(context, '[', ']', [&]{
+      container.insert(codec.decode(context));
+    });
+  }
+};
+
+/**
+ * Inserter for containers that have a reserve method, which is used when the
+ * array_t codec is asked to count the elements before decoding them.
+ */
+template <typename base_inserter>
+struct reserving_inserter : public base_inserter {
+  static const bool can_reserve = true;
+
+  template <typename container_type>
+  static void reserve(container_type &container, size_t size) {
+    container.reserve(size);
+  }
 };
 
+/**
+ * The number of elements to reserve room for when count_array_elements has
+ * counted count elements. The count comes from a scan that does not validate
+ * the elements, so malformed input such as "[,,,]" can make it much larger than
+ * the array that is decoded. Every element but the last takes at least two
+ * bytes of input, and no more than max_reserved_array_bytes are reserved up
+ * front. Longer arrays grow as usual while they are decoded.
+ */
+template <typename value_type>
+size_t array_reserve_count(const decode_context &context, const size_t count) {
+  static constexpr size_t max_reserved_array_bytes = 1 << 20;
+  const auto max_count = std::max<size_t>(max_reserved_array_bytes / sizeof(value_type), 1);
+  return std::min({ count, context.remaining() / 2 + 1, max_count });
+}
+
 template <typename T> struct container_inserter;
 
 template <typename T>
-struct container_inserter<std::vector<T>> : public sequence_inserter {};
+struct container_inserter<std::vector<T>> : public reserving_inserter<sequence_inserter> {};
 
 template <typename T>
 struct container_inserter<std::deque<T>> : public sequence_inserter {};
@@ -113,7 +206,7 @@ template <typename T>
 struct container_inserter<std::set<T>> : public associative_inserter {};
 
 template <typename T>
-struct container_inserter<std::unordered_set<T>> : public associative_inserter {};
+struct container_inserter<std::unordered_set<T>> : public reserving_inserter<associative_inserter> {};
 
 }  // namespace detail
 
@@ -135,12 +228,20 @@ class array_t final {
           typename T::value_type>::value,
       "Inner codec type must be convertible to array container type");
 
-  explicit array_t(codec_type &&inner_codec) : _inner_codec(std::move(inner_codec)) {}
-  explicit array_t(const codec_type &inner_codec) : _inner_codec(inner_codec) {}
+  explicit array_t(codec_type &&inner_codec, bool count_elements = false)
+      : _inner_codec(std::move(inner_codec)),
+        _count_elements(count_elements) {}
+  explicit array_t(const codec_type &inner_codec, bool count_elements = false)
+      : _inner_codec(inner_codec),
+        _count_elements(count_elements) {}
 
   object_type decode(decode_context &context) const {
     using inserter = detail::container_inserter<T>;
     object_type output;
+    if (inserter::can_reserve && _count_elements) {
+      const auto count = detail::count_array_elements(context);
+      inserter::reserve(output, detail::array_reserve_count<typename T::value_type>(context, count));
+    }
     typename inserter::state state = inserter::init_state;
     detail::decode_comma_separated(context, '[', ']', [&]{
       state = inserter::insert(
@@ -150,6 +251,10 @@ class array_t final {
     return output;
   }
 
+  void decode_into(decode_context &context, object_type &value) const {
+    detail::container_inserter<T>::decode_into(context, value, _inner_codec);
+  }
+
   void encode(encode_context &context, const object_type &array) const {
     context.append('[');
     for (const auto &element : array) {
@@ -161,8 +266,13 @@ class array_t final {
     context.append_or_replace(',', ']');
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::token_array;
+  }
+
  private:
   codec_type _inner_codec;
+  bool _count_elements;
 };
 
 template <typename T, typename codec_type>
@@ -170,6 +280,20 @@ array_t<T, typename std::decay<codec_type>::type> array(codec_type &&inner_codec
   return array_t<T, typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec));
 }
 
+/**
+ * Like array, but the decoded container is reserved to the number of elements
+ * in the JSON array before they are decoded. The elements are counted with a
+ * structural scan that skips over them. This reads the array twice, but
+ * avoids reallocating and moving already decoded elements as the container
+ * grows, which pays off when the elements are expensive to move, for example
+ * strings or objects. It has no effect for containers without reserve(). The
+ * reservation is capped, see detail::array_reserve_count.
+ */
+template <typename T, typename codec_type>
+array_t<T, typename std::decay<codec_type>::type> counted_array(codec_type &&inner_codec) {
+  return array_t<T, typename std::decay<codec_type>::type>(std::forward<codec_type>(inner_codec), true);
+}
+
 }  // namespace codec
 
 template <typename T>
@@ -18,6 +18,7 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -30,6 +31,10 @@ class boolean_t final {
 
   object_type decode(decode_context &context) const;
   void encode(encode_context &context, const object_type value) const;
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_boolean;
+  }
 };
 
 inline boolean_t boolean() {
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+
 #include <boost/chrono.hpp>
 #include <boost/container/flat_map.hpp>
 #include <boost/make_shared.hpp>
@@ -67,6 +70,36 @@ boost_optional_t<typename std::decay<codec_type>::type> boost_optional(codec_typ
 
 }  // namespace codec
 
+namespace detail {
+
+/**
+ * Builds flat maps by sorting all entries at once and constructing the map
+ * from the sorted range, instead of inserting into the middle of the flat map
+ * once per entry.
+ */
+template <typename T>
+struct map_builder<boost::container::flat_map<std::string, T>>
+    : public scratch_vector_map_builder<boost::container::flat_map<std::string, T>> {
+  using map_type = boost::container::flat_map<std::string, T>;
+  using scratch_type = typename scratch_vector_map_builder<map_type>::scratch_type;
+  using entry_type = typename scratch_type::value_type;
+
+  static map_type build(scratch_type &&scratch) {
+    // The sort is stable and unique keeps the first of equal keys, so the
+    // first value of a duplicated key wins, like with insert.
+    const auto key_less = [](const entry_type &a, const entry_type &b) { return a.first < b.first; };
+    const auto key_equal = [](const entry_type &a, const entry_type &b) { return a.first == b.first; };
+    std::stable_sort(scratch.begin(), scratch.end(), key_less);
+    const auto end = std::unique(scratch.begin(), scratch.end(), key_equal);
+    return map_type(
+        boost::container::ordered_unique_range,
+        std::make_move_iterator(scratch.begin()),
+        std::make_move_iterator(end));
+  }
+};
+
+}  // namespace detail
+
 template <typename T>
 struct default_codec_t<boost::shared_ptr<T>> {
   static decltype(codec::boost_shared_ptr(default_codec<T>())) codec() {
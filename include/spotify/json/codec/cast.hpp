@@ -20,6 +20,7 @@
 #include <utility>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -53,6 +54,10 @@ class cast_t {
     _inner_codec.encode(context, codec_cast<inner_type, T>::cast(value));
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(_inner_codec);
+  }
+
  private:
   codec_type _inner_codec;
 };
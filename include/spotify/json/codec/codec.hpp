@@ -25,6 +25,8 @@
 #include <spotify/json/codec/empty_as.hpp>
 #include <spotify/json/codec/enumeration.hpp>
 #include <spotify/json/codec/eq.hpp>
+#include <spotify/json/codec/filter.hpp>
+#include <spotify/json/codec/frozen.hpp>
 #include <spotify/json/codec/ignore.hpp>
 #include <spotify/json/codec/map.hpp>
 #include <spotify/json/codec/null.hpp>
@@ -33,7 +35,10 @@
 #include <spotify/json/codec/omit.hpp>
 #include <spotify/json/codec/one_of.hpp>
 #include <spotify/json/codec/optional.hpp>
+#include <spotify/json/codec/shared_string.hpp>
 #include <spotify/json/codec/smart_ptr.hpp>
+#include <spotify/json/codec/static_object.hpp>
 #include <spotify/json/codec/string.hpp>
 #include <spotify/json/codec/transform.hpp>
 #include <spotify/json/codec/tuple.hpp>
+#include <spotify/json/codec/variant.hpp>
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -75,6 +76,50 @@ class codec_interface final {
    * should be thrown.
    */
   bool should_encode(const object_type &value) const;
+
+  /**
+   * This method is optional.
+   *
+   * If it is present, it returns the kinds of JSON values (detail::token_object,
+   * detail::token_string and so on, combined as a bit mask) that the decode
+   * method is able to decode. Codecs that choose between several inner codecs,
+   * such as one_of_t, use this to avoid invoking codecs that would certainly
+   * fail. A codec without this method is assumed to accept any kind of value.
+   *
+   * A codec must never leave out a kind of value that it might successfully
+   * decode. Declaring a kind of value that it then fails to decode is fine.
+   */
+  detail::token_mask accepted_tokens() const;
+
+  /**
+   * This method is optional.
+   *
+   * If it is present, it decodes into an existing value instead of returning a
+   * new one, reusing memory that the value has already allocated, such as the
+   * buffer of a string or the elements of a vector. The result must be the
+   * same as assigning the result of decode; codecs for objects reset fields
+   * that are not present in the input. If decoding fails, the value may be
+   * left partially updated.
+   *
+   * Use detail::decode_into to call it, which falls back to decode for codecs
+   * that do not have this method.
+   */
+  void decode_into(decode_context &context, object_type &value) const;
+
+  /**
+   * This method is optional, and only makes sense for codecs of JSON objects.
+   *
+   * If it is present, it decodes an object whose opening brace and first
+   * key/value pair have already been read by the caller, with the context
+   * right after the first value. The first key/value pair is not part of the
+   * decoded value. variant_t uses this when the discriminator is the first key
+   * of the object, so that it does not have to read the object from the start
+   * again.
+   *
+   * Use detail::decode_after_first_member to call it, which falls back to
+   * decoding the whole object again for codecs that do not have this method.
+   */
+  object_type decode_after_first_member(decode_context &context) const;
 };
 
 }  // namespace codec
@@ -22,6 +22,8 @@
 #include <spotify/json/codec/omit.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -47,6 +49,15 @@ class empty_as_t final {
         _inner_codec(std::forward<inner_codec_arg_type>(inner_codec)) {}
 
   object_type decode(decode_context &context) const {
+    const auto token = detail::peek_token(context);
+    const auto inner_accepts = (detail::accepted_tokens(_inner_codec) & token);
+    const auto empty_accepts = (detail::accepted_tokens(_empty_codec) & token);
+    if (!empty_accepts) {
+      return _inner_codec.decode(context);
+    } else if (!inner_accepts) {
+      return decode_empty(context);
+    }
+
     const auto original_position = context.position;
     try {
       return _inner_codec.decode(context);
@@ -78,7 +89,23 @@ class empty_as_t final {
     }
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(_empty_codec) | detail::accepted_tokens(_inner_codec);
+  }
+
  private:
+  json_never_inline object_type decode_empty(decode_context &context) const {
+    const auto original_position = context.position;
+    try {
+      return _empty_codec.decode(context);
+    } catch (const decode_exception &) {
+      // Only the empty codec accepts this kind of value, but the error of the
+      // inner codec is still the more interesting one to report.
+      context.position = original_position;
+      return _inner_codec.decode(context);
+    }
+  }
+
   empty_codec_type _empty_codec;
   inner_codec_type _inner_codec;
   object_type _default = object_type();
@@ -17,28 +17,88 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
 namespace json {
+namespace detail {
+
+template <typename T>
+struct is_less_than_comparable {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<const U &>() < std::declval<const U &>(),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Integral and enum values can be looked up in a table indexed by the value,
+ * when the values are dense enough.
+ */
+template <typename T, bool = std::is_enum<T>::value>
+struct enumeration_dense_key {
+  using type = typename std::conditional<std::is_integral<T>::value, T, void>::type;
+};
+
+template <typename T>
+struct enumeration_dense_key<T, true> {
+  using type = typename std::underlying_type<T>::type;
+};
+
+}  // namespace detail
+
 namespace codec {
 
 /**
  * Codec that maps values from a set of JSON values to values of another C++
  * type. This is useful for enums.
+ *
+ * Lookup tables are built when the codec is constructed. When decoding, the
+ * inner value is binary searched for in a sorted table, if it can be compared
+ * with '<'. String enumerations that use string_t are matched against the raw
+ * bytes of the input, so that no std::string is allocated unless the input
+ * contains escape sequences. When encoding, integral and enum values that are
+ * dense enough are looked up by index; other values are binary searched for.
+ * Types that cannot be compared with '<' fall back to a linear search. When a
+ * value is mapped more than once, the first mapping wins.
  */
 template <typename outer_type, typename codec_type>
 class enumeration_t final {
   using inner_type = typename codec_type::object_type;
   using mapping_type = std::vector<std::pair<outer_type, inner_type>>;
+  using dense_key_type = typename detail::enumeration_dense_key<outer_type>::type;
+
+  using is_raw_string = std::integral_constant<bool,
+      std::is_same<codec_type, string_t>::value>;
+  using is_inner_sortable = std::integral_constant<bool,
+      detail::is_less_than_comparable<inner_type>::value>;
+  using is_outer_sortable = std::integral_constant<bool,
+      detail::is_less_than_comparable<outer_type>::value>;
+  using is_outer_dense = std::integral_constant<bool,
+      !std::is_void<dense_key_type>::value>;
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
 
  public:
   using object_type = outer_type;
@@ -46,36 +106,178 @@ class enumeration_t final {
   template <typename codec_arg_type>
   enumeration_t(codec_arg_type &&inner_codec, mapping_type &&mapping)
       : _inner_codec(std::forward<codec_arg_type>(inner_codec)),
-        _mapping(std::move(mapping)) {}
+        _mapping(std::move(mapping)) {
+    build_decode_index(is_inner_sortable());
+    build_encode_index(is_outer_sortable());
+    build_encode_table(is_outer_dense());
+  }
 
   object_type decode(decode_context &context) const {
-    const auto result = _inner_codec.decode(context);
-    const auto it = std::find_if(_mapping.begin(), _mapping.end(), [&](const std::pair<outer_type, inner_type> &pair) {
-      return pair.second == result;
-    });
-    detail::fail_if(context, it == _mapping.end(), "Encountered unknown enumeration value");
-    return it->first;
+    const auto index = decode_index(context, is_raw_string());
+    detail::fail_if(context, index == npos, "Encountered unknown enumeration value");
+    return _mapping[index].first;
   }
 
   void encode(encode_context &context, const object_type &value) const {
-    const auto it = find(value);
-    detail::fail_if(context, it == _mapping.end(), "Encoding unknown enumeration value");
-    _inner_codec.encode(context, (*it).second);
+    const auto index = find(value);
+    detail::fail_if(context, index == npos, "Encoding unknown enumeration value");
+    _inner_codec.encode(context, _mapping[index].second);
   }
 
   bool should_encode(const object_type &value) const {
-    return find(value) != _mapping.end();
+    return find(value) != npos;
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(_inner_codec);
   }
 
  private:
-  json_never_inline typename mapping_type::const_iterator find(const object_type &value) const {
-    return std::find_if(_mapping.begin(), _mapping.end(), [&](const std::pair<outer_type, inner_type> &pair) {
-      return pair.first == value;
+  /*
+   * Decoding
+   */
+
+  void build_decode_index(std::false_type /*is_inner_sortable*/) {}
+
+  void build_decode_index(std::true_type /*is_inner_sortable*/) {
+    _decode_index = sorted_indices([](const std::pair<outer_type, inner_type> &pair) -> const inner_type & {
+      return pair.second;
+    });
+  }
+
+  size_t decode_index(decode_context &context, std::false_type /*is_raw_string*/) const {
+    return find_inner(_inner_codec.decode(context), is_inner_sortable());
+  }
+
+  size_t decode_index(decode_context &context, std::true_type /*is_raw_string*/) const {
+    detail::skip_1(context, '"');
+    const auto begin = context.position;
+    detail::skip_any_simple_characters(context);
+
+    switch (detail::next(context, "Unterminated string")) {
+      case '"': return find_inner(std::string_view(begin, context.position - 1 - begin), std::true_type());
+      case '\\':
+        context.position = begin - 1;
+        return find_inner(_inner_codec.decode(context), std::true_type());
+      default: json_unreachable();
+    }
+  }
+
+  template <typename value_type>
+  size_t find_inner(const value_type &value, std::false_type /*is_inner_sortable*/) const {
+    for (size_t i = 0; i < _mapping.size(); i++) {
+      if (_mapping[i].second == value) {
+        return i;
+      }
+    }
+    return npos;
+  }
+
+  template <typename value_type>
+  size_t find_inner(const value_type &value, std::true_type /*is_inner_sortable*/) const {
+    const auto it = std::lower_bound(_decode_index.begin(), _decode_index.end(), value, [&](const size_t index, const value_type &v) {
+      return _mapping[index].second < v;
+    });
+    return (it != _decode_index.end() && _mapping[*it].second == value) ? *it : npos;
+  }
+
+  /*
+   * Encoding
+   */
+
+  void build_encode_index(std::false_type /*is_outer_sortable*/) {}
+
+  void build_encode_index(std::true_type /*is_outer_sortable*/) {
+    _encode_index = sorted_indices([](const std::pair<outer_type, inner_type> &pair) -> const outer_type & {
+      return pair.first;
+    });
+  }
+
+  void build_encode_table(std::false_type /*is_outer_dense*/) {}
+
+  void build_encode_table(std::true_type /*is_outer_dense*/) {
+    if (_mapping.empty()) {
+      return;
+    }
+
+    auto min = dense_key(_mapping.front().first);
+    auto max = min;
+    for (const auto &pair : _mapping) {
+      min = std::min(min, dense_key(pair.first));
+      max = std::max(max, dense_key(pair.first));
+    }
+
+    // Only use a table when it is not much larger than the mapping itself.
+    const auto range = uintmax_t(max) - uintmax_t(min);
+    if (range >= std::max<uintmax_t>(64, 4 * _mapping.size())) {
+      return;
+    }
+
+    _encode_table_min = min;
+    _encode_table.assign(size_t(range) + 1, npos);
+    for (size_t i = _mapping.size(); i > 0; i--) {
+      _encode_table[uintmax_t(dense_key(_mapping[i - 1].first)) - uintmax_t(min)] = i - 1;
+    }
+  }
+
+  static dense_key_type dense_key(const outer_type &value) {
+    return static_cast<dense_key_type>(value);
+  }
+
+  json_never_inline size_t find(const object_type &value) const {
+    return find_outer(value, is_outer_dense());
+  }
+
+  size_t find_outer(const object_type &value, std::false_type /*is_outer_dense*/) const {
+    return find_outer_sorted(value, is_outer_sortable());
+  }
+
+  size_t find_outer(const object_type &value, std::true_type /*is_outer_dense*/) const {
+    if (_encode_table.empty()) {
+      return find_outer_sorted(value, is_outer_sortable());
+    }
+    const auto offset = uintmax_t(dense_key(value)) - uintmax_t(_encode_table_min);
+    return offset < _encode_table.size() ? _encode_table[size_t(offset)] : npos;
+  }
+
+  size_t find_outer_sorted(const object_type &value, std::false_type /*is_outer_sortable*/) const {
+    for (size_t i = 0; i < _mapping.size(); i++) {
+      if (_mapping[i].first == value) {
+        return i;
+      }
+    }
+    return npos;
+  }
+
+  size_t find_outer_sorted(const object_type &value, std::true_type /*is_outer_sortable*/) const {
+    const auto it = std::lower_bound(_encode_index.begin(), _encode_index.end(), value, [&](const size_t index, const object_type &v) {
+      return _mapping[index].first < v;
+    });
+    return (it != _encode_index.end() && _mapping[*it].first == value) ? *it : npos;
+  }
+
+  /**
+   * Indices into the mapping, stably sorted by the key that 'get_key' returns.
+   * The stable sort makes lower_bound find the first mapping of a value.
+   */
+  template <typename get_key_type>
+  std::vector<size_t> sorted_indices(const get_key_type &get_key) const {
+    std::vector<size_t> indices(_mapping.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+      indices[i] = i;
+    }
+    std::stable_sort(indices.begin(), indices.end(), [&](const size_t a, const size_t b) {
+      return get_key(_mapping[a]) < get_key(_mapping[b]);
     });
+    return indices;
   }
 
   codec_type _inner_codec;
   mapping_type _mapping;
+  std::vector<size_t> _decode_index;
+  std::vector<size_t> _encode_index;
+  std::vector<size_t> _encode_table;
+  typename std::conditional<is_outer_dense::value, dense_key_type, char>::type _encode_table_min{};
 };
 
 template <typename outer_type, typename codec_type>
@@ -58,6 +58,10 @@ class eq_t final {
     return detail::should_encode(_inner_codec, value);
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(_inner_codec);
+  }
+
  private:
   codec_type _inner_codec;
   object_type _value;
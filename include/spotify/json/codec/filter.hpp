@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * A predicate on one field of a JSON object, for use with filtered_array,
+ * count_array and fold_array. The value of the field is decoded with the given
+ * codec and passed to the predicate. Objects that do not have the field do not
+ * match.
+ */
+template <typename codec_type, typename predicate_type>
+class where_t final {
+ public:
+  where_t(std::string field_name, codec_type codec, predicate_type predicate)
+      : _field_name(std::move(field_name)),
+        _codec(std::move(codec)),
+        _predicate(std::move(predicate)) {}
+
+  const std::string &field_name() const {
+    return _field_name;
+  }
+
+  bool matches(decode_context &context) const {
+    return _predicate(_codec.decode(context));
+  }
+
+ private:
+  std::string _field_name;
+  codec_type _codec;
+  predicate_type _predicate;
+};
+
+template <typename codec_type, typename predicate_type>
+where_t<typename std::decay<codec_type>::type, typename std::decay<predicate_type>::type> where(
+    std::string field_name,
+    codec_type &&codec,
+    predicate_type &&predicate) {
+  return where_t<typename std::decay<codec_type>::type, typename std::decay<predicate_type>::type>(
+      std::move(field_name),
+      std::forward<codec_type>(codec),
+      std::forward<predicate_type>(predicate));
+}
+
+}  // namespace codec
+
+namespace detail {
+
+/**
+ * Evaluates a set of where_t predicates against the fields of a JSON object in
+ * a single pass over it, without decoding the object itself.
+ */
+template <typename... predicates_type>
+class element_filter final {
+ public:
+  explicit element_filter(predicates_type... predicates)
+      : _predicates(std::move(predicates)...) {}
+
+  /**
+   * Scan the object at the current position and return true if all predicates
+   * match. Values of fields that the predicates do not look at are given to
+   * on_other_field, which returns false if it did not consume the value; such
+   * values are skipped. Leaves the context after the object.
+   */
+  template <typename on_other_field_function>
+  bool matches(decode_context &context, on_other_field_function on_other_field) const {
+    fail_if(context, peek(context) != '{', "Expected object");
+
+    std::array<bool, sizeof...(predicates_type)> seen{};
+    string_view_t key_codec;
+    auto is_match = true;
+    decode_comma_separated(context, '{', '}', [&]{
+      const auto key = key_codec.decode(context);
+      skip_any_whitespace(context);
+      skip_1(context, ':');
+      skip_any_whitespace(context);
+      if (!match_field(context, key, seen, is_match, std::index_sequence_for<predicates_type...>())) {
+        if (!on_other_field(key)) {
+          skip_value(context);
+        }
+      }
+    });
+
+    for (const auto was_seen : seen) {
+      is_match = is_match && was_seen;
+    }
+    return is_match;
+  }
+
+ private:
+  template <size_t... indices>
+  bool match_field(
+      [[maybe_unused]] decode_context &context,
+      [[maybe_unused]] const std::string_view key,
+      [[maybe_unused]] std::array<bool, sizeof...(predicates_type)> &seen,
+      [[maybe_unused]] bool &is_match,
+      std::index_sequence<indices...>) const {
+    return (... || match_field<indices>(context, key, seen, is_match));
+  }
+
+  template <size_t index>
+  bool match_field(
+      decode_context &context,
+      const std::string_view key,
+      std::array<bool, sizeof...(predicates_type)> &seen,
+      bool &is_match) const {
+    const auto &predicate = std::get<index>(_predicates);
+    if (seen[index] || key != predicate.field_name()) {
+      return false;
+    }
+
+    seen[index] = true;
+    if (is_match) {
+      is_match = predicate.matches(context);
+    } else {
+      skip_value(context);  // the object is already known not to match
+    }
+    return true;
+  }
+
+  std::tuple<predicates_type...> _predicates;
+};
+
+template <typename T>
+struct sum_fold final {
+  void operator()(T &sum, const T value) const {
+    sum += value;
+  }
+};
+
+}  // namespace detail
+
+namespace codec {
+
+/**
+ * Codec for arrays of JSON objects that only decodes the elements that match
+ * all of the given where_t predicates. Each element is first scanned for the
+ * fields that the predicates look at; elements that do not match are skipped
+ * without being decoded, and elements that match are decoded from the start
+ * with the inner codec. Encoding writes all elements of the container.
+ */
+template <typename T, typename codec_type, typename... predicates_type>
+class filtered_array_t final {
+ public:
+  using object_type = T;
+
+  static_assert(
+      std::is_convertible<
+          typename std::decay<codec_type>::type::object_type,
+          typename T::value_type>::value,
+      "Inner codec type must be convertible to array container type");
+
+  filtered_array_t(codec_type inner_codec, predicates_type... predicates)
+      : _inner_codec(std::move(inner_codec)),
+        _filter(std::move(predicates)...) {}
+
+  object_type decode(decode_context &context) const {
+    using inserter = detail::container_inserter<T>;
+    object_type output;
+    typename inserter::state state = inserter::init_state;
+    detail::decode_comma_separated(context, '[', ']', [&]{
+      const auto element_begin = context.position;
+      if (_filter.matches(context, [](const std::string_view) { return false; })) {
+        context.position = element_begin;
+        state = inserter::insert(context, state, output, _inner_codec.decode(context));
+      }
+    });
+    inserter::validate(context, state, output);
+    return output;
+  }
+
+  void encode(encode_context &context, const object_type &array) const {
+    context.append('[');
+    for (const auto &element : array) {
+      if (json_likely(detail::should_encode(_inner_codec, element))) {
+        _inner_codec.encode(context, element);
+        context.append(',');
+      }
+    }
+    context.append_or_replace(',', ']');
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_array;
+  }
+
+ private:
+  codec_type _inner_codec;
+  detail::element_filter<predicates_type...> _filter;
+};
+
+template <typename T, typename codec_type, typename... predicates_type>
+filtered_array_t<T, typename std::decay<codec_type>::type, predicates_type...> filtered_array(
+    codec_type &&inner_codec,
+    predicates_type... predicates) {
+  return filtered_array_t<T, typename std::decay<codec_type>::type, predicates_type...>(
+      std::forward<codec_type>(inner_codec),
+      std::move(predicates)...);
+}
+
+/**
+ * Codec that decodes an array of JSON objects into the number of elements
+ * that match all of the given where_t predicates, without decoding any of the
+ * elements. It cannot encode.
+ */
+template <typename... predicates_type>
+class count_array_t final {
+ public:
+  using object_type = size_t;
+
+  explicit count_array_t(predicates_type... predicates)
+      : _filter(std::move(predicates)...) {}
+
+  object_type decode(decode_context &context) const {
+    size_t count = 0;
+    detail::decode_comma_separated(context, '[', ']', [&]{
+      count += _filter.matches(context, [](const std::string_view) { return false; }) ? 1 : 0;
+    });
+    return count;
+  }
+
+  void encode(encode_context &context, const object_type & /*value*/) const {
+    detail::fail(context, "count_array_t codec cannot encode");
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_array;
+  }
+
+ private:
+  detail::element_filter<predicates_type...> _filter;
+};
+
+template <typename... predicates_type>
+count_array_t<predicates_type...> count_array(predicates_type... predicates) {
+  return count_array_t<predicates_type...>(std::move(predicates)...);
+}
+
+/**
+ * Codec that folds one field of the elements of an array of JSON objects into
+ * a single value, without decoding the elements themselves. For each element
+ * that has the field and matches all of the given where_t predicates, the
+ * value of the field is decoded with the field codec and passed to the fold
+ * function together with the accumulated value. The folded field cannot also
+ * be a predicate field; compare the value in the fold function instead. It
+ * cannot encode.
+ */
+template <typename T, typename field_codec_type, typename fold_type, typename... predicates_type>
+class fold_array_t final {
+ public:
+  using object_type = T;
+  using field_type = typename field_codec_type::object_type;
+
+  fold_array_t(
+      T initial_value,
+      std::string field_name,
+      field_codec_type field_codec,
+      fold_type fold,
+      predicates_type... predicates)
+      : _initial_value(std::move(initial_value)),
+        _field_name(std::move(field_name)),
+        _field_codec(std::move(field_codec)),
+        _fold(std::move(fold)),
+        _filter(std::move(predicates)...) {}
+
+  object_type decode(decode_context &context) const {
+    auto accumulated = _initial_value;
+    std::optional<field_type> field;
+    detail::decode_comma_separated(context, '[', ']', [&]{
+      field.reset();
+      const auto is_match = _filter.matches(context, [&](const std::string_view key) {
+        if (field || key != _field_name) {
+          return false;
+        }
+        field.emplace(_field_codec.decode(context));
+        return true;
+      });
+      if (is_match && field) {
+        _fold(accumulated, std::move(*field));
+      }
+    });
+    return accumulated;
+  }
+
+  void encode(encode_context &context, const object_type & /*value*/) const {
+    detail::fail(context, "fold_array_t codec cannot encode");
+  }
+
+ private:
+  T _initial_value;
+  std::string _field_name;
+  field_codec_type _field_codec;
+  fold_type _fold;
+  detail::element_filter<predicates_type...> _filter;
+};
+
+template <typename T, typename field_codec_type, typename fold_type, typename... predicates_type>
+fold_array_t<T, typename std::decay<field_codec_type>::type, typename std::decay<fold_type>::type, predicates_type...> fold_array(
+    T initial_value,
+    std::string field_name,
+    field_codec_type &&field_codec,
+    fold_type &&fold,
+    predicates_type... predicates) {
+  return fold_array_t<T, typename std::decay<field_codec_type>::type, typename std::decay<fold_type>::type, predicates_type...>(
+      std::move(initial_value),
+      std::move(field_name),
+      std::forward<field_codec_type>(field_codec),
+      std::forward<fold_type>(fold),
+      std::move(predicates)...);
+}
+
+/**
+ * Sum a numeric field over the elements of an array of JSON objects that
+ * match all of the given where_t predicates. Elements without the field are
+ * not counted.
+ */
+template <typename T, typename... predicates_type>
+fold_array_t<T, number_t<T>, detail::sum_fold<T>, predicates_type...> sum_array(
+    std::string field_name,
+    predicates_type... predicates) {
+  return fold_array_t<T, number_t<T>, detail::sum_fold<T>, predicates_type...>(
+      T(0),
+      std::move(field_name),
+      number<T>(),
+      detail::sum_fold<T>(),
+      std::move(predicates)...);
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * A codec that refers to a codec owned by a frozen_t. Copying it copies a
+ * pointer, so unlike copying object_t or any_codec_t it touches no reference
+ * counts, and it can be copied freely between threads and into other codecs.
+ * It must not outlive the frozen_t that it refers to.
+ */
+template <typename codec_type>
+class frozen_ref_t final {
+ public:
+  using object_type = typename codec_type::object_type;
+
+  explicit frozen_ref_t(const codec_type &codec)
+      : _codec(&codec) {}
+
+  json_force_inline object_type decode(decode_context &context) const {
+    return _codec->decode(context);
+  }
+
+  json_force_inline void decode_into(decode_context &context, object_type &value) const {
+    detail::decode_into(*_codec, context, value);
+  }
+
+  json_force_inline void encode(encode_context &context, const object_type &value) const {
+    _codec->encode(context, value);
+  }
+
+  bool should_encode(const object_type &value) const {
+    return detail::should_encode(*_codec, value);
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(*_codec);
+  }
+
+  const codec_type &codec() const {
+    return *_codec;
+  }
+
+ private:
+  const codec_type *_codec;
+};
+
+/**
+ * An immutable codec tree that is built once, typically at startup, and then
+ * shared by reference. The codec is moved into a single allocation that is
+ * never modified again and that keeps its address when the frozen_t is moved,
+ * so any number of threads can decode and encode with it, or with the
+ * frozen_ref_t codecs returned by ref(), without copying any part of it.
+ *
+ * frozen_t can not be copied; copying it would defeat its purpose.
+ */
+template <typename codec_type>
+class frozen_t final {
+ public:
+  using object_type = typename codec_type::object_type;
+
+  explicit frozen_t(codec_type &&codec)
+      : _codec(new codec_type(std::move(codec))) {}
+
+  explicit frozen_t(const codec_type &codec)
+      : _codec(new codec_type(codec)) {}
+
+  frozen_t(frozen_t &&) = default;
+  frozen_t(const frozen_t &) = delete;
+  frozen_t &operator=(frozen_t &&) = default;
+  frozen_t &operator=(const frozen_t &) = delete;
+
+  json_force_inline object_type decode(decode_context &context) const {
+    return _codec->decode(context);
+  }
+
+  json_force_inline void decode_into(decode_context &context, object_type &value) const {
+    detail::decode_into(*_codec, context, value);
+  }
+
+  json_force_inline void encode(encode_context &context, const object_type &value) const {
+    _codec->encode(context, value);
+  }
+
+  bool should_encode(const object_type &value) const {
+    return detail::should_encode(*_codec, value);
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(*_codec);
+  }
+
+  frozen_ref_t<codec_type> ref() const {
+    return frozen_ref_t<codec_type>(*_codec);
+  }
+
+  const codec_type &codec() const {
+    return *_codec;
+  }
+
+ private:
+  std::unique_ptr<const codec_type> _codec;
+};
+
+template <typename codec_type>
+frozen_t<typename std::decay<codec_type>::type> freeze(codec_type &&codec) {
+  return frozen_t<typename std::decay<codec_type>::type>(std::forward<codec_type>(codec));
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
@@ -16,18 +16,122 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/skip_value.hpp>
 
 namespace spotify {
 namespace json {
+namespace detail {
+
+/**
+ * Inserts the entries directly into the map as they are decoded. When a key
+ * appears more than once, the first value is kept.
+ */
+template <typename T>
+struct inserting_map_builder {
+  using scratch_type = T;
+
+  static scratch_type make_scratch(const decode_context &) {
+    return scratch_type();
+  }
+
+  static void reserve(T &, const decode_context &) {
+    // Nothing to reserve
+  }
+
+  template <typename value_type>
+  static void insert(scratch_type &scratch, std::string &&key, value_type &&value) {
+    scratch.insert(typename T::value_type(std::move(key), std::forward<value_type>(value)));
+  }
+
+  static T build(scratch_type &&scratch) {
+    return std::move(scratch);
+  }
+};
+
+/**
+ * Builds a map of type T while it is being decoded. The entries are inserted
+ * into a scratch object made with make_scratch, which is turned into the map
+ * with build once the whole JSON object has been decoded. When a key appears
+ * more than once, the first value is kept.
+ *
+ * The default is to insert the entries directly into the map.
+ */
+template <typename T>
+struct map_builder : public inserting_map_builder<T> {};
+
+/**
+ * Builds hash maps that are reserved to the number of members of the object,
+ * as counted by count_object_members, so that they are not rehashed while the
+ * entries are inserted. Like for counted arrays, the count does not validate
+ * the members, so it is capped at what the rest of the input can hold: every
+ * member but the last takes at least five bytes, as in "":0,.
+ */
+template <typename T>
+struct reserving_map_builder : public inserting_map_builder<T> {
+  static T make_scratch(const decode_context &context) {
+    T map;
+    reserve(map, context);
+    return map;
+  }
+
+  static void reserve(T &map, const decode_context &context) {
+    const auto count = count_object_members(context);
+    map.reserve(std::min(count, context.remaining() / 5 + 1));
+  }
+};
+
+template <typename T>
+struct map_builder<std::unordered_map<std::string, T>>
+    : public reserving_map_builder<std::unordered_map<std::string, T>> {};
+
+/**
+ * Collects the entries into a vector, so that maps that keep their entries in
+ * a sorted vector, like flat_map, can be built in one step instead of moving
+ * the entries after each inserted entry. Node based maps and hash maps insert
+ * each entry directly, since collecting the entries first would only add an
+ * extra move and allocation per entry.
+ */
+template <typename T>
+struct scratch_vector_map_builder {
+  using scratch_type = std::vector<std::pair<std::string, typename T::mapped_type>>;
+
+  static scratch_type make_scratch(const decode_context &) {
+    return scratch_type();
+  }
+
+  template <typename value_type>
+  static void insert(scratch_type &scratch, std::string &&key, value_type &&value) {
+    scratch.emplace_back(std::move(key), std::forward<value_type>(value));
+  }
+};
+
+template <typename T>
+struct has_node_type {
+  template <typename U>
+  static auto test(int) -> decltype(std::declval<typename U::node_type>(), std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+}  // namespace detail
+
 namespace codec {
 
 template <typename T, typename codec_type>
@@ -53,14 +157,18 @@ class map_t final {
   explicit map_t(const codec_type &inner_codec) : _inner_codec(inner_codec) {}
 
   object_type decode(decode_context &context) const {
-    using value_type = typename object_type::value_type;
-    object_type output;
+    using builder = detail::map_builder<object_type>;
+    auto scratch = builder::make_scratch(context);
     detail::decode_object<string_t>(
         context,
         [&](std::string &&key) {
-          output.insert(value_type(std::move(key), _inner_codec.decode(context)));
+          builder::insert(scratch, std::move(key), _inner_codec.decode(context));
         });
-    return output;
+    return builder::build(std::move(scratch));
+  }
+
+  void decode_into(decode_context &context, object_type &value) const {
+    decode_into(context, value, std::integral_constant<bool, detail::has_node_type<object_type>::value>());
   }
 
   void encode(encode_context &context, const object_type &map) const {
@@ -76,7 +184,38 @@ class map_t final {
     context.append_or_replace(',', '}');
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::token_object;
+  }
+
  private:
+  void decode_into(decode_context &context, object_type &value, std::false_type /*has_node_type*/) const {
+    value = decode(context);
+  }
+
+  /**
+   * For node based maps, the nodes of keys that are decoded again are moved
+   * over to the new map and their values are decoded into. Nodes of keys that
+   * are no longer present are freed along with the old map.
+   */
+  void decode_into(decode_context &context, object_type &value, std::true_type /*has_node_type*/) const {
+    using value_type = typename object_type::value_type;
+    object_type output;
+    detail::map_builder<object_type>::reserve(output, context);
+    detail::decode_object<string_t>(
+        context,
+        [&](std::string &&key) {
+          auto node = value.extract(key);
+          if (node) {
+            detail::decode_into(_inner_codec, context, node.mapped());
+            output.insert(std::move(node));
+          } else {
+            output.insert(value_type(std::move(key), _inner_codec.decode(context)));
+          }
+        });
+    value = std::move(output);
+  }
+
   string_t _string_codec;
   codec_type _inner_codec;
 };
@@ -46,6 +46,10 @@ class null_t final {
     context.append("null", 4);
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::token_null;
+  }
+
  private:
   object_type _value;
 };
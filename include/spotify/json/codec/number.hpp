@@ -28,6 +28,7 @@
 #include <spotify/json/detail/encode_integer.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/slow_path_counters.hpp>
 
 namespace spotify {
 namespace json {
@@ -73,6 +74,10 @@ class floating_point_t {
   json_force_inline void encode(encode_context &context, const object_type &value) const {
     encode_floating_point<object_type>(context, value);
   }
+
+  json_force_inline token_mask accepted_tokens() const {
+    return token_number;
+  }
 };
 
 template <typename T, bool is_positive>
@@ -276,6 +281,8 @@ json_never_inline T handle_overflowing_exponent(
  */
 template <typename T, bool is_positive>
 json_never_inline T decode_integer_tricky(decode_context &context, const char *int_beg) {
+  json_count_slow_path(decode_integer_tricky);
+
   // Find [xxxx].yyyyE±zzzz
   auto int_end = find_non_digit(int_beg, context.end);
   context.position = int_end;
@@ -386,6 +393,10 @@ class integer_t<T, true, false> {
   json_force_inline void encode(encode_context &context, const object_type value) const {
     encode_positive_integer(context, value);
   }
+
+  json_force_inline token_mask accepted_tokens() const {
+    return token_number;
+  }
 };
 
 template <typename T>
@@ -406,6 +417,10 @@ class integer_t<T, true, true> {
       encode_positive_integer(context, value);
     }
   }
+
+  json_force_inline token_mask accepted_tokens() const {
+    return token_number;
+  }
 };
 
 template <typename T>
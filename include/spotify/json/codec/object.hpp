@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <initializer_list>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/codec/string.hpp>
@@ -30,10 +34,53 @@
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_value.hpp>
 #include <spotify/json/encode_context.hpp>
+#include <spotify/json/unknown_fields.hpp>
 
 namespace spotify {
 namespace json {
 namespace codec {
+namespace codec_detail {
+struct object_t_base;
+}  // namespace codec_detail
+
+/**
+ * A runtime selected subset of the fields of an object_t codec. Projections
+ * are created with object_t::projection and can only be used with the codec
+ * that created them, or copies of it, and only as long as no fields are added
+ * to the codec. object_t checks this and throws std::invalid_argument for
+ * projections that do not match it.
+ */
+class field_projection final {
+ public:
+  /**
+   * Whether the field at field_index is selected. Indices past the fields
+   * that the projection was created for are not selected.
+   */
+  bool is_selected(size_t field_index) const {
+    return field_index < _selected.size() && _selected[field_index];
+  }
+
+  size_t num_required_fields() const {
+    return _num_required_fields;
+  }
+
+ private:
+  friend struct codec_detail::object_t_base;
+
+  field_projection(size_t num_fields, const void *first_field)
+      : _selected(num_fields, false),
+        _first_field(first_field) {}
+
+  std::vector<bool> _selected;
+  size_t _num_required_fields = 0;
+
+  /**
+   * The first field of the codec that created the projection, which copies of
+   * the codec share, to tell it apart from other codecs with as many fields.
+   */
+  const void *_first_field;
+};
+
 namespace codec_detail {
 
 struct object_t_base {
@@ -44,13 +91,26 @@ struct object_t_base {
     virtual ~construct_untyped() = default;
   };
 
+  struct unknown_fields_untyped {
+    virtual ~unknown_fields_untyped() = default;
+    virtual unknown_fields &get(void *object) const = 0;
+    virtual const unknown_fields &get(const void *object) const = 0;
+  };
+
   object_t_base();
   object_t_base(construct_untyped *construct);
   object_t_base(object_t_base &&other);
   object_t_base(const object_t_base &other);
 
   void decode(decode_context &context, void *value) const;
+  void decode(decode_context &context, void *value, const field_projection &projection) const;
+  void decode_after_first_member(decode_context &context, void *value) const;
+  void decode_into(decode_context &context, void *value, const void *prototype) const;
   void encode(encode_context &context, const void *value) const;
+  void encode(encode_context &context, const void *value, const field_projection &projection) const;
+
+  field_projection make_projection(const std::vector<std::string> &names) const;
+  void check_projection(const field_projection &projection) const;
 
   detail::field_registry _fields;
 
@@ -60,6 +120,11 @@ struct object_t_base {
    * if T is default constructible.
    */
   std::shared_ptr<const construct_untyped> _construct;
+
+  /**
+   * The member that unknown fields are captured into, if any.
+   */
+  std::shared_ptr<const unknown_fields_untyped> _unknown_fields;
 };
 
 }  // namespace codec_detail
@@ -95,16 +160,84 @@ class object_t final : public codec_detail::object_t_base {
     add_field(name, true, std::forward<args_type>(args)...);
   }
 
+  /**
+   * Capture the key/value pairs of the object that the codec has no field for
+   * into member, instead of skipping them, and encode them again after the
+   * other fields. The captured fields point into the input, which must outlive
+   * them. They are not captured or encoded when using a projection.
+   */
+  template <typename object_type>
+  void capture_unknown_fields(json::unknown_fields object_type::*member) {
+    _unknown_fields = std::make_shared<unknown_fields_member<json::unknown_fields object_type::*>>(member);
+  }
+
   json_never_inline object_type decode(decode_context &context) const {
     object_type value = construct(std::is_default_constructible<T>());
     object_t_base::decode(context, &value);
     return value;
   }
 
+  /**
+   * Decode the rest of an object whose first key/value pair has already been
+   * read, see codec_interface.
+   */
+  json_never_inline object_type decode_after_first_member(decode_context &context) const {
+    object_type value = construct(std::is_default_constructible<T>());
+    object_t_base::decode_after_first_member(context, &value);
+    return value;
+  }
+
+  /**
+   * Decode into the fields of an existing object, reusing the memory that its
+   * fields have allocated. Fields that are not present in the input are reset
+   * by copying them from an object that is made once, the way decode makes
+   * them, so the result is the same as that of decode.
+   */
+  void decode_into(decode_context &context, object_type &value) const {
+    object_t_base::decode_into(context, &value, &prototype());
+  }
+
   json_force_inline void encode(encode_context &context, const object_type &value) const {
     object_t_base::encode(context, &value);
   }
 
+  /**
+   * Create a projection that selects the fields with the given names. Throws
+   * std::invalid_argument if the codec does not have a field with one of the
+   * names. Creating a projection is relatively expensive; the projection can
+   * then be used any number of times with decode and encode.
+   */
+  field_projection projection(const std::vector<std::string> &names) const {
+    return make_projection(names);
+  }
+
+  field_projection projection(std::initializer_list<std::string> names) const {
+    return make_projection(std::vector<std::string>(names));
+  }
+
+  /**
+   * Decode only the fields that are selected by the projection. Other fields
+   * are skipped without being decoded, and are left as they were when the
+   * object was constructed. Required fields are only required if they are
+   * selected.
+   */
+  json_never_inline object_type decode(decode_context &context, const field_projection &projection) const {
+    object_type value = construct(std::is_default_constructible<T>());
+    object_t_base::decode(context, &value, projection);
+    return value;
+  }
+
+  /**
+   * Encode only the fields that are selected by the projection.
+   */
+  void encode(encode_context &context, const object_type &value, const field_projection &projection) const {
+    object_t_base::encode(context, &value, projection);
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_object;
+  }
+
  private:
   T construct(std::true_type /*is_default_constructible*/) const {
     if (json_unlikely(_construct)) {
@@ -122,6 +255,25 @@ class object_t final : public codec_detail::object_t_base {
     return typed();
   }
 
+  /**
+   * The object that decode_into resets fields that are not in the input to.
+   * It is made with construct the first time it is needed, and shared by
+   * copies of the codec.
+   */
+  struct prototype_holder {
+    std::once_flag once;
+    std::optional<T> value;
+  };
+
+  const T &prototype() const {
+    std::call_once(_prototype->once, [this] {
+      _prototype->value.emplace(construct(std::is_default_constructible<T>()));
+    });
+    return *_prototype->value;
+  }
+
+  std::shared_ptr<prototype_holder> _prototype = std::make_shared<prototype_holder>();
+
   template <typename codec_type>
   struct codec_field : public detail::field {
     codec_field(bool required, size_t required_field_idx, codec_type &&codec)
@@ -176,12 +328,23 @@ class object_t final : public codec_detail::object_t_base {
       typed.*member = this->codec.decode(context);
     }
 
+    void decode_into(decode_context &context, void *object) const override {
+      auto &typed = *static_cast<object_type *>(object);
+      detail::decode_into(this->codec, context, typed.*member);
+    }
+
     void encode(encode_context &context, const std::string &key, const void *object) const override {
       const auto &typed = *static_cast<const object_type *>(object);
       const auto &value = typed.*member;
       this->append_kv(context, key, value);
     }
 
+    void reset(void *object, const void *prototype) const override {
+      auto &typed = *static_cast<object_type *>(object);
+      const auto &typed_prototype = *static_cast<const object_type *>(prototype);
+      detail::reset_value(typed.*member, typed_prototype.*member);
+    }
+
     member_ptr member;
   };
 
@@ -208,6 +371,17 @@ class object_t final : public codec_detail::object_t_base {
       this->append_kv(context, key, value);
     }
 
+    void reset(void *object, const void *prototype) const override {
+      using value_type = typename codec_type::object_type;
+      auto &typed = *static_cast<object_type *>(object);
+      const auto &typed_prototype = *static_cast<const object_type *>(prototype);
+      if constexpr (std::is_copy_constructible<value_type>::value) {
+        (typed.*setter)(value_type((typed_prototype.*getter)()));
+      } else if constexpr (std::is_default_constructible<value_type>::value) {
+        (typed.*setter)(value_type());
+      }
+    }
+
     getter_ptr getter;
     setter_ptr setter;
   };
@@ -237,6 +411,17 @@ class object_t final : public codec_detail::object_t_base {
       this->append_kv(context, key, value);
     }
 
+    void reset(void *object, const void *prototype) const override {
+      using value_type = typename codec_type::object_type;
+      auto &typed = *static_cast<object_type *>(object);
+      const auto &typed_prototype = *static_cast<const object_type *>(prototype);
+      if constexpr (std::is_copy_constructible<value_type>::value) {
+        set(typed, value_type(get(typed_prototype)));
+      } else if constexpr (std::is_default_constructible<value_type>::value) {
+        set(typed, value_type());
+      }
+    }
+
     getter get;
     setter set;
   };
@@ -331,6 +516,22 @@ class object_t final : public codec_detail::object_t_base {
         std::forward<codec_type>(codec))));
   }
 
+  template <typename member_ptr>
+  struct unknown_fields_member final : public unknown_fields_untyped {
+    explicit unknown_fields_member(member_ptr fields_member)
+        : member(fields_member) {}
+
+    json::unknown_fields &get(void *object) const override {
+      return static_cast<object_type *>(object)->*member;
+    }
+
+    const json::unknown_fields &get(const void *object) const override {
+      return static_cast<const object_type *>(object)->*member;
+    }
+
+    member_ptr member;
+  };
+
   struct construct_callable : public construct_untyped {
     virtual T operator()() const = 0;
   };
@@ -347,11 +548,55 @@ class object_t final : public codec_detail::object_t_base {
   };
 };
 
+/**
+ * Codec that decodes and encodes only the fields of an object_t codec that are
+ * selected by a projection. It keeps a copy of the object_t codec, so it is
+ * best created once and reused; to select fields per call, call decode and
+ * encode on the object_t codec with the projection instead.
+ */
+template <typename T>
+class projected_t final {
+ public:
+  using object_type = T;
+
+  projected_t(object_t<T> codec, field_projection projection)
+      : _codec(std::move(codec)),
+        _projection(std::move(projection)) {}
+
+  object_type decode(decode_context &context) const {
+    return _codec.decode(context, _projection);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    _codec.encode(context, value, _projection);
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_object;
+  }
+
+ private:
+  object_t<T> _codec;
+  field_projection _projection;
+};
+
 template <typename T>
 object_t<T> object() {
   return object_t<T>();
 }
 
+template <typename T>
+projected_t<T> projected(object_t<T> codec, std::initializer_list<std::string> names) {
+  auto projection = codec.projection(names);
+  return projected_t<T>(std::move(codec), std::move(projection));
+}
+
+template <typename T>
+projected_t<T> projected(object_t<T> codec, const std::vector<std::string> &names) {
+  auto projection = codec.projection(names);
+  return projected_t<T>(std::move(codec), std::move(projection));
+}
+
 template <typename create_function>
 auto object(create_function &&create) -> object_t<decltype(create())> {
   return object_t<decltype(create())>(std::forward<create_function>(create));
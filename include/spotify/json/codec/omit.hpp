@@ -43,6 +43,10 @@ class omit_t final {
   bool should_encode(const object_type & /*value*/) const {
     return false;
   }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_none;
+  }
 };
 
 template <typename T>
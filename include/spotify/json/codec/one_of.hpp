@@ -20,6 +20,8 @@
 #include <type_traits>
 
 #include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -41,28 +43,56 @@ struct codecs_share_same_object_type<codec_type_1, codec_type_2, codecs_type...>
               typename codec_type_2::object_type>::value &&
           codecs_share_same_object_type<codec_type_2, codecs_type...>::value> {};
 
+/**
+ * Tries the codecs in the tuple in order, starting with the one at index
+ * (tuple size - N). Codecs that have declared that they cannot decode the kind
+ * of value at the current input position are skipped without being invoked. A
+ * codec is only wrapped in a try/catch when there is a later codec that could
+ * take over if it fails; otherwise it is invoked directly.
+ */
 template <typename tuple_type, size_t N>
 struct try_each_codec {
-  using object_type = typename std::tuple_element<
-      std::tuple_size<tuple_type>::value - N, tuple_type>::type::object_type;
+  static constexpr size_t index = std::tuple_size<tuple_type>::value - N;
+  using object_type = typename std::tuple_element<index, tuple_type>::type::object_type;
+  using next = try_each_codec<tuple_type, N - 1>;
+
+  static token_mask accepted_tokens(const tuple_type &tuple) {
+    return detail::accepted_tokens(std::get<index>(tuple)) | next::accepted_tokens(tuple);
+  }
+
+  static object_type decode(const tuple_type &tuple, decode_context &context, const token_mask token) {
+    const auto &codec = std::get<index>(tuple);
+    if (!(detail::accepted_tokens(codec) & token)) {
+      return next::decode(tuple, context, token);
+    }
+
+    if (!(next::accepted_tokens(tuple) & token)) {
+      return codec.decode(context);
+    }
 
-  static object_type decode(const tuple_type &tuple, decode_context &context) {
     const auto original_position = context.position;
     try {
-      return std::get<std::tuple_size<tuple_type>::value - N>(tuple).decode(context);
+      return codec.decode(context);
     } catch (const decode_exception &) {
       context.position = original_position;
-      return try_each_codec<tuple_type, N - 1>::decode(tuple, context);
+      return next::decode(tuple, context, token);
     }
   }
 };
 
 template <typename tuple_type>
-struct try_each_codec<tuple_type, 0> {
-  using object_type = typename std::tuple_element<0, tuple_type>::type::object_type;
+struct try_each_codec<tuple_type, 1> {
+  static constexpr size_t index = std::tuple_size<tuple_type>::value - 1;
+  using object_type = typename std::tuple_element<index, tuple_type>::type::object_type;
+
+  static token_mask accepted_tokens(const tuple_type &tuple) {
+    return detail::accepted_tokens(std::get<index>(tuple));
+  }
 
-  static object_type decode(const tuple_type &tuple, decode_context &context) {
-    return std::get<std::tuple_size<tuple_type>::value - 1>(tuple).decode(context);
+  static object_type decode(const tuple_type &tuple, decode_context &context, const token_mask /*token*/) {
+    // This is the last codec, so there is nothing to fall back to. Even if it
+    // does not accept the token, let it fail with its own error message.
+    return std::get<index>(tuple).decode(context);
   }
 };
 
@@ -72,7 +102,9 @@ namespace codec {
 
 /**
  * Takes an ordered list of codecs and applies them one by one. The first
- * one that succeeds will be used.
+ * one that succeeds will be used. Codecs that declare which kinds of JSON
+ * values they accept (see codec_interface.hpp) are skipped without being
+ * tried when the input holds some other kind of value.
  *
  * When encoding, the first codec is always used.
  */
@@ -90,8 +122,7 @@ class one_of_t final {
       : _codecs(std::forward<Args>(args)...) {}
 
   object_type decode(decode_context &context) const {
-    return detail::try_each_codec<
-        decltype(_codecs), std::tuple_size<decltype(_codecs)>::value>::decode(_codecs, context);
+    return try_each::decode(_codecs, context, detail::peek_token(context));
   }
 
   void encode(encode_context &context, const object_type &value) const {
@@ -102,8 +133,15 @@ class one_of_t final {
     return detail::should_encode(std::get<0>(_codecs), value);
   }
 
+  detail::token_mask accepted_tokens() const {
+    return try_each::accepted_tokens(_codecs);
+  }
+
  private:
-  std::tuple<codec_type, codecs_type ...> _codecs;
+  using tuple_type = std::tuple<codec_type, codecs_type ...>;
+  using try_each = detail::try_each_codec<tuple_type, std::tuple_size<tuple_type>::value>;
+
+  tuple_type _codecs;
 };
 
 template <typename... codecs_type>
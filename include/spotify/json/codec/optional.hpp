@@ -55,6 +55,10 @@ class optional_t {
     return false;
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(_inner_codec);
+  }
+
  private:
   codec_type _inner_codec;
 };
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/shared_string.hpp>
+
+namespace spotify {
+namespace json {
+namespace codec {
+
+/**
+ * A codec for shared_string. When the decode_context has an input_owner, as it
+ * does in decode_shared, strings without escape sequences are decoded without
+ * copying into shared_strings that point into the input. Other strings are
+ * copied into a shared_string of their own.
+ */
+class shared_string_t final {
+ public:
+  using object_type = shared_string;
+
+  object_type decode(decode_context &context) const;
+  void encode(encode_context &context, const object_type &value) const;
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_string;
+  }
+};
+
+inline shared_string_t shared_string_codec() {
+  return shared_string_t();
+}
+
+}  // namespace codec
+
+template <>
+struct default_codec_t<shared_string> {
+  static codec::shared_string_t codec() {
+    return codec::shared_string_t();
+  }
+};
+
+}  // namespace json
+}  // namespace spotify
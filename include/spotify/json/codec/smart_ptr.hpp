@@ -20,6 +20,7 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
@@ -73,6 +74,10 @@ class smart_ptr_t final {
     return bool(value);
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(_inner_codec);
+  }
+
  protected:
   codec_type _inner_codec;
 };
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * The key of a field as it is encoded, "name": with quotes and colon, made at
+ * compile time. Names that would need escaping are rejected, which is a
+ * compile error when the codec is constexpr.
+ */
+template <size_t name_size>
+constexpr std::array<char, name_size + 2> make_static_key(const char (&name)[name_size]) {
+  std::array<char, name_size + 2> key{};
+  key[0] = '"';
+  for (size_t i = 0; i + 1 < name_size; i++) {
+    const auto c = name[i];
+    if (uint8_t(c) < 0x20 || c == '"' || c == '\\') {
+      throw std::invalid_argument("static_object field names must not need escaping");
+    }
+    key[i + 1] = c;
+  }
+  key[name_size] = '"';
+  key[name_size + 1] = ':';
+  return key;
+}
+
+/**
+ * The default codec for a value type, default constructed when the codec type
+ * allows it so that it can be used in constant expressions.
+ */
+template <typename value_type>
+constexpr auto static_default_codec() {
+  using codec_type = typename std::decay<decltype(default_codec<value_type>())>::type;
+  if constexpr (std::is_default_constructible<codec_type>::value) {
+    return codec_type();
+  } else {
+    return default_codec<value_type>();
+  }
+}
+
+}  // namespace detail
+
+namespace codec {
+
+/**
+ * A field of a static_object_t. Fields are made with static_required and
+ * static_optional.
+ */
+template <size_t name_size, typename member_ptr, typename codec_type>
+struct static_field_t final {
+  constexpr static_field_t(const char (&name)[name_size], bool required, member_ptr member, codec_type codec)
+      : key(detail::make_static_key(name)),
+        required(required),
+        member(member),
+        codec(codec) {}
+
+  constexpr std::string_view name() const {
+    return std::string_view(key.data() + 1, name_size - 1);
+  }
+
+  template <typename object_type>
+  json_force_inline void decode(decode_context &context, object_type &object, const bool into) const {
+    if (into) {
+      detail::decode_into(codec, context, object.*member);
+    } else {
+      object.*member = codec.decode(context);
+    }
+  }
+
+  template <typename object_type>
+  void reset(object_type &object, const object_type &prototype) const {
+    detail::reset_value(object.*member, prototype.*member);
+  }
+
+  template <typename object_type>
+  json_force_inline void encode(encode_context &context, const object_type &object) const {
+    const auto &value = object.*member;
+    if (json_likely(detail::should_encode(codec, value))) {
+      context.append(key.data(), key.size());
+      codec.encode(context, value);
+      context.append(',');
+    }
+  }
+
+  std::array<char, name_size + 2> key;
+  bool required;
+  member_ptr member;
+  codec_type codec;
+};
+
+template <size_t name_size, typename value_type, typename object_type, typename codec_type>
+constexpr static_field_t<name_size, value_type object_type::*, codec_type> static_required(
+    const char (&name)[name_size],
+    value_type object_type::*member,
+    codec_type codec) {
+  return static_field_t<name_size, value_type object_type::*, codec_type>(name, true, member, codec);
+}
+
+template <size_t name_size, typename value_type, typename object_type>
+constexpr auto static_required(const char (&name)[name_size], value_type object_type::*member) {
+  return static_required(name, member, detail::static_default_codec<value_type>());
+}
+
+template <size_t name_size, typename value_type, typename object_type, typename codec_type>
+constexpr static_field_t<name_size, value_type object_type::*, codec_type> static_optional(
+    const char (&name)[name_size],
+    value_type object_type::*member,
+    codec_type codec) {
+  return static_field_t<name_size, value_type object_type::*, codec_type>(name, false, member, codec);
+}
+
+template <size_t name_size, typename value_type, typename object_type>
+constexpr auto static_optional(const char (&name)[name_size], value_type object_type::*member) {
+  return static_optional(name, member, detail::static_default_codec<value_type>());
+}
+
+/**
+ * A codec for objects like object_t, with its fields fixed at compile time.
+ * When the codecs of its fields are literal types, as the codecs for strings,
+ * numbers and booleans are, the whole codec can be constexpr: the keys are
+ * escaped and the fields are laid out at compile time, and building it costs
+ * nothing at startup and allocates nothing.
+ *
+ * Fields are looked up by comparing the key with each field name in turn,
+ * which is fast for the small objects that this codec is meant for. Unlike
+ * object_t, static_object_t does not record field profiles.
+ */
+template <typename T, typename... field_types>
+class static_object_t final {
+ public:
+  using object_type = T;
+
+  static_assert(
+      std::is_default_constructible<T>::value,
+      "static_object_t can only be used with default constructible types");
+  static_assert(
+      sizeof...(field_types) > 0,
+      "static_object_t must have at least one field");
+
+  constexpr explicit static_object_t(field_types... fields)
+      : _fields(fields...) {}
+
+  object_type decode(decode_context &context) const {
+    object_type value;
+    decode_fields(context, value, false, false);
+    return value;
+  }
+
+  /**
+   * Decode the rest of an object whose first key/value pair has already been
+   * read, see codec_interface.
+   */
+  object_type decode_after_first_member(decode_context &context) const {
+    object_type value;
+    decode_fields(context, value, false, true);
+    return value;
+  }
+
+  /**
+   * Decode into the fields of an existing object, reusing the memory that its
+   * fields have allocated. Fields that are not present in the input are reset
+   * to their values in a default constructed object, as decode leaves them.
+   */
+  void decode_into(decode_context &context, object_type &value) const {
+    decode_fields(context, value, true, false);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    context.append('{');
+    std::apply([&](const field_types &... fields) { (fields.encode(context, value), ...); }, _fields);
+    context.append_or_replace(',', '}');
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_object;
+  }
+
+ private:
+  static constexpr size_t num_fields = sizeof...(field_types);
+  using field_indices = std::index_sequence_for<field_types...>;
+
+  void decode_fields(
+      decode_context &context,
+      object_type &value,
+      const bool into,
+      const bool after_first_member) const {
+    std::bitset<num_fields> seen;
+    const auto decode_member = [&](const std::string_view key) {
+      if (json_unlikely(!decode_field(context, key, value, into, seen, field_indices()))) {
+        detail::skip_value(context);
+      }
+    };
+    if (json_unlikely(after_first_member)) {
+      detail::decode_object_after_first_member<detail::string_view_t>(context, decode_member);
+    } else {
+      detail::decode_object<detail::string_view_t>(context, decode_member);
+    }
+    detail::fail_if(context, is_missing_required_fields(seen, field_indices()), "Missing required field(s)");
+    if (into) {
+      reset_unseen_fields(value, seen, field_indices());
+    }
+  }
+
+  template <size_t... indices>
+  void reset_unseen_fields(
+      object_type &value,
+      const std::bitset<num_fields> &seen,
+      std::index_sequence<indices...>) const {
+    if (seen.all()) {
+      return;
+    }
+    static const object_type prototype = object_type();
+    ((seen[indices] || (std::get<indices>(_fields).reset(value, prototype), true)), ...);
+  }
+
+  template <size_t... indices>
+  json_force_inline bool decode_field(
+      decode_context &context,
+      const std::string_view key,
+      object_type &value,
+      const bool into,
+      std::bitset<num_fields> &seen,
+      std::index_sequence<indices...>) const {
+    return ((key == std::get<indices>(_fields).name() &&
+             (std::get<indices>(_fields).decode(context, value, into), seen.set(indices), true)) || ...);
+  }
+
+  template <size_t... indices>
+  bool is_missing_required_fields(
+      const std::bitset<num_fields> &seen,
+      std::index_sequence<indices...>) const {
+    return ((std::get<indices>(_fields).required && !seen[indices]) || ...);
+  }
+
+  std::tuple<field_types...> _fields;
+};
+
+template <typename T, typename... field_types>
+constexpr static_object_t<T, field_types...> static_object(field_types... fields) {
+  return static_object_t<T, field_types...>(fields...);
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
@@ -17,8 +17,13 @@
 #pragma once
 
 #include <algorithm>
+#include <string>
+#include <string_view>
+
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -30,7 +35,12 @@ class string_t final {
   using object_type = std::string;
 
   object_type decode(decode_context &context) const;
-  void encode(encode_context &context, const object_type value) const;
+  void decode_into(decode_context &context, object_type &value) const;
+  void encode(encode_context &context, const object_type &value) const;
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_string;
+  }
 };
 
 inline string_t string() {
@@ -39,6 +49,35 @@ inline string_t string() {
 
 }  // namespace codec
 
+namespace detail {
+
+/**
+ * Decodes strings, such as object keys, without copying them. Strings without
+ * escape sequences are returned as views into the input, and the rare strings
+ * with escape sequences are unescaped into a buffer that is reused for the
+ * next string, which the view is valid until.
+ */
+class string_view_t final {
+ public:
+  std::string_view decode(decode_context &context) {
+    skip_1(context, '"');
+    const auto begin = context.position;
+    skip_any_simple_characters(context);
+    if (json_likely(next(context, "Unterminated string") == '"')) {
+      return std::string_view(begin, size_t(context.position - 1 - begin));
+    }
+
+    context.position = begin - 1;
+    codec::string().decode_into(context, _escaped);
+    return _escaped;
+  }
+
+ private:
+  std::string _escaped;
+};
+
+}  // namespace detail
+
 template <>
 struct default_codec_t<std::string> {
   static codec::string_t codec() {
@@ -20,6 +20,7 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/encode_context.hpp>
 
 namespace spotify {
@@ -141,6 +142,10 @@ class transform_t final {
     _inner_codec.encode(context, _encode_transform(value));
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::accepted_tokens(_inner_codec);
+  }
+
  private:
   codec_type _inner_codec;
   encode_transform _encode_transform;
@@ -93,6 +93,10 @@ class tuple_t final {
     context.append_or_replace(',', ']');
   }
 
+  detail::token_mask accepted_tokens() const {
+    return detail::token_array;
+  }
+
  private:
   std::tuple<codecs_type ...> _codecs;
 };
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_context.hpp>
+#include <spotify/json/detail/decode_helpers.hpp>
+#include <spotify/json/detail/encode_helpers.hpp>
+#include <spotify/json/detail/macros.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode_context.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * The index of the first codec in codecs_type... whose object_type is T, or
+ * the number of codecs if there is no such codec.
+ */
+template <typename T, typename... codecs_type>
+struct variant_codec_index;
+
+template <typename T>
+struct variant_codec_index<T> : std::integral_constant<size_t, 0> {};
+
+template <typename T, typename codec_type, typename... codecs_type>
+struct variant_codec_index<T, codec_type, codecs_type...>
+    : std::integral_constant<
+          size_t,
+          std::is_same<T, typename codec_type::object_type>::value ?
+              0 : 1 + variant_codec_index<T, codecs_type...>::value> {};
+
+template <typename variant_type, typename... codecs_type>
+struct variant_codecs_cover_alternatives;
+
+template <typename... Ts, typename... codecs_type>
+struct variant_codecs_cover_alternatives<std::variant<Ts...>, codecs_type...>
+    : std::integral_constant<
+          bool,
+          (... && (variant_codec_index<Ts, codecs_type...>::value < sizeof...(codecs_type)))> {};
+
+/**
+ * Decodes with the codec at runtime index 'i' of the tuple, starting the search
+ * at index (tuple size - N). decode_with is called with the codec and returns
+ * the decoded value.
+ */
+template <typename variant_type, typename tuple_type, size_t N>
+struct decode_variant_alternative {
+  static constexpr size_t index = std::tuple_size<tuple_type>::value - N;
+  using object_type = typename std::tuple_element<index, tuple_type>::type::object_type;
+
+  template <typename decode_function>
+  static variant_type decode(const tuple_type &codecs, const size_t i, const decode_function &decode_with) {
+    if (i == index) {
+      return variant_type(std::in_place_type<object_type>, decode_with(std::get<index>(codecs)));
+    }
+    return decode_variant_alternative<variant_type, tuple_type, N - 1>::decode(codecs, i, decode_with);
+  }
+};
+
+template <typename variant_type, typename tuple_type>
+struct decode_variant_alternative<variant_type, tuple_type, 0> {
+  template <typename decode_function>
+  static variant_type decode(const tuple_type &, const size_t, const decode_function &) {
+    json_unreachable();
+  }
+};
+
+}  // namespace detail
+
+namespace codec {
+
+/**
+ * Codec for std::variant types that are encoded as JSON objects with a
+ * discriminator field, for example {"type":"a",...}. Each alternative has a tag
+ * and a codec that encodes the object; the value of the discriminator field
+ * selects the codec to decode with.
+ *
+ * When decoding, the keys of the object are scanned until the discriminator is
+ * found, skipping over the values before it. Keys and tags are compared as
+ * views into the input, without copying them. When the discriminator is the
+ * first key, the rest of the object is decoded in place with the selected codec
+ * if it supports that, as object_t and static_object_t do, and the
+ * discriminator is never seen by it. Otherwise the object is decoded from the
+ * start, and the discriminator is an unknown field that the codec skips over.
+ *
+ * When encoding, the discriminator is written as the first field of the object.
+ * The alternative codecs should therefore not have a field for it themselves.
+ */
+template <typename T, typename... codecs_type>
+class variant_t final {
+ public:
+  using object_type = T;
+
+  static_assert(
+      detail::variant_codecs_cover_alternatives<T, codecs_type...>::value,
+      "variant_t needs a codec for every alternative of the variant type");
+
+  template <typename... alternatives_type>
+  explicit variant_t(std::string discriminator, alternatives_type &&...alternatives)
+      : _discriminator(std::move(discriminator)),
+        _codecs(std::forward<alternatives_type>(alternatives).second...) {
+    _tags = { std::string(alternatives.first)... };
+    for (const auto &tag : _tags) {
+      _prefixes.push_back(escape_prefix(tag));
+    }
+  }
+
+  object_type decode(decode_context &context) const {
+    const auto begin = context.position;
+    bool is_first_key = false;
+    const auto index = find_alternative(context, is_first_key);
+    if (is_first_key) {
+      return decode_alternative(index, [&](const auto &codec) {
+        return detail::decode_after_first_member(codec, context, begin);
+      });
+    }
+
+    context.position = begin;
+    return decode_alternative(index, [&](const auto &codec) { return codec.decode(context); });
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    std::visit([&](const auto &alternative) {
+      using alternative_type = typename std::decay<decltype(alternative)>::type;
+      constexpr auto index = detail::variant_codec_index<alternative_type, codecs_type...>::value;
+      const auto offset = context.size();
+      std::get<index>(_codecs).encode(context, alternative);
+      insert_prefix(context, offset, _prefixes[index]);
+    }, value);
+  }
+
+  bool should_encode(const object_type &value) const {
+    return std::visit([&](const auto &alternative) {
+      using alternative_type = typename std::decay<decltype(alternative)>::type;
+      constexpr auto index = detail::variant_codec_index<alternative_type, codecs_type...>::value;
+      return detail::should_encode(std::get<index>(_codecs), alternative);
+    }, value);
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_object;
+  }
+
+ private:
+  using tuple_type = std::tuple<codecs_type...>;
+
+  std::string escape_prefix(const std::string &tag) const {
+    encode_context context;
+    _string_codec.encode(context, _discriminator);
+    context.append(':');
+    _string_codec.encode(context, tag);
+    return std::string(context.data(), context.size());
+  }
+
+  template <typename decode_function>
+  object_type decode_alternative(const size_t index, const decode_function &decode_with) const {
+    return detail::decode_variant_alternative<
+        object_type, tuple_type, sizeof...(codecs_type)>::decode(_codecs, index, decode_with);
+  }
+
+  /**
+   * Find the discriminator and return the index of the alternative that its
+   * value refers to. When the discriminator is the first key of the object,
+   * is_first_key is set and the context is left right after its value.
+   * Otherwise the context is left somewhere inside the object.
+   */
+  size_t find_alternative(decode_context &context, bool &is_first_key) const {
+    detail::string_view_t keys;
+    detail::skip_1(context, '{');
+    detail::skip_any_whitespace(context);
+    is_first_key = true;
+
+    while (json_likely(detail::peek(context) != '}')) {
+      const auto key = keys.decode(context);
+      detail::skip_any_whitespace(context);
+      detail::skip_1(context, ':');
+      detail::skip_any_whitespace(context);
+
+      if (key == _discriminator) {
+        return find_tag(context);
+      }
+
+      detail::skip_value(context);
+      detail::skip_any_whitespace(context);
+      if (detail::peek(context) != '}') {
+        detail::skip_1(context, ',');
+        detail::skip_any_whitespace(context);
+      }
+      is_first_key = false;
+    }
+
+    detail::fail(context, "Missing variant discriminator field");
+  }
+
+  /**
+   * Decode the value of the discriminator and return the index of the
+   * alternative with that tag. There are few alternatives, so the tags are
+   * compared in turn.
+   */
+  size_t find_tag(decode_context &context) const {
+    const auto tag_position = context.position;
+    detail::string_view_t tags;
+    const auto tag = tags.decode(context);
+    for (size_t i = 0; i < _tags.size(); i++) {
+      if (tag == _tags[i]) {
+        return i;
+      }
+    }
+
+    context.position = tag_position;
+    detail::fail(context, "Encountered unknown variant discriminator value");
+  }
+
+  /**
+   * Insert the escaped "discriminator":"tag" prefix right after the opening
+   * brace of the object that was encoded at 'offset'.
+   */
+  static void insert_prefix(encode_context &context, const size_t offset, const std::string &prefix) {
+    const auto object_size = context.size() - offset;
+    const auto needs_comma = (object_size > 2);  // more than just {}
+    const auto inserted_size = prefix.size() + (needs_comma ? 1 : 0);
+    const auto end = context.reserve(inserted_size);
+    const auto object = end - object_size;
+    detail::fail_if(context, object_size < 2 || object[0] != '{', "variant_t alternatives must encode objects");
+
+    std::memmove(object + 1 + inserted_size, object + 1, object_size - 1);
+    std::memcpy(object + 1, prefix.data(), prefix.size());
+    if (needs_comma) {
+      object[1 + prefix.size()] = ',';
+    }
+    context.advance(inserted_size);
+  }
+
+  std::string _discriminator;
+  tuple_type _codecs;
+  std::vector<std::string> _tags;
+  std::vector<std::string> _prefixes;
+  string_t _string_codec;
+};
+
+/**
+ * Create a variant_t codec. Each alternative is a pair of a tag and the codec
+ * for that alternative, for example:
+ *
+ *   variant<std::variant<A, B>>(
+ *       "type",
+ *       std::make_pair("a", codec_a),
+ *       std::make_pair("b", codec_b));
+ */
+template <typename T, typename... alternatives_type>
+variant_t<T, typename std::decay<typename std::decay<alternatives_type>::type::second_type>::type...> variant(
+    std::string discriminator,
+    alternatives_type &&...alternatives) {
+  return variant_t<T, typename std::decay<typename std::decay<alternatives_type>::type::second_type>::type...>(
+      std::move(discriminator),
+      std::forward<alternatives_type>(alternatives)...);
+}
+
+}  // namespace codec
+}  // namespace json
+}  // namespace spotify
@@ -17,37 +17,109 @@
 #pragma once
 
 #include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/padded_buffer.hpp>
+#include <spotify/json/stats.hpp>
 
 namespace spotify {
 namespace json {
+namespace detail {
+
+/**
+ * Inputs that know that they are padded (padded_string_view and padded_buffer)
+ * get a padded decode_context, and all other inputs a plain one. Plain inputs
+ * are not copied into a padded_buffer, since decoded values such as
+ * encoded_value_ref may point into the input.
+ */
+template <typename string_type>
+decode_context make_decode_context(const string_type &string) {
+  if constexpr (std::is_convertible<const string_type &, padded_string_view>::value) {
+    return decode_context(static_cast<padded_string_view>(string));
+  } else {
+    return decode_context(string.data(), string.size());
+  }
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode_document(const codec_type &codec, decode_context &c) {
+  stats_scope stats(stats_operation::decode);
+  skip_any_whitespace(c);
+  const auto result = codec.decode(c);
+  skip_any_whitespace(c);
+  fail_if(c, c.position != c.end, "Unexpected trailing input");
+  stats.succeeded(c.end - c.begin);
+  return result;
+}
+
+template <typename codec_type>
+void decode_document_into(
+    const codec_type &codec,
+    decode_context &c,
+    typename codec_type::object_type &object) {
+  stats_scope stats(stats_operation::decode);
+  skip_any_whitespace(c);
+  detail::decode_into(codec, c, object);
+  skip_any_whitespace(c);
+  fail_if(c, c.position != c.end, "Unexpected trailing input");
+  stats.succeeded(c.end - c.begin);
+}
+
+}  // namespace detail
 
 /*
  * json::decode(codec, data...)
  */
 
 template <typename codec_type>
-typename codec_type::object_type decode(const codec_type &codec, const char *data, size_t size) {
+typename codec_type::object_type decode(
+    const codec_type &codec,
+    const char *data,
+    size_t size,
+    const decode_options &options) {
   decode_context c(data, data + size);
-  detail::skip_any_whitespace(c);
-  const auto result = codec.decode(c);
-  detail::skip_any_whitespace(c);
-  detail::fail_if(c, c.position != c.end, "Unexpected trailing input");
-  return result;
+  c.validate_utf8 = options.validate_utf8;
+  return detail::decode_document(codec, c);
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode(
+    const codec_type &codec,
+    const char *cstr,
+    const decode_options &options) {
+  return decode(codec, cstr, cstr ? std::strlen(cstr) : 0, options);
+}
+
+template <typename codec_type, typename string_type>
+typename codec_type::object_type decode(
+    const codec_type &codec,
+    const string_type &string,
+    const decode_options &options) {
+  auto c = detail::make_decode_context(string);
+  c.validate_utf8 = options.validate_utf8;
+  return detail::decode_document(codec, c);
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode(const codec_type &codec, const char *data, size_t size) {
+  return decode(codec, data, size, decode_options());
 }
 
 template <typename codec_type>
 typename codec_type::object_type decode(const codec_type &codec, const char *cstr) {
-  return decode(codec, cstr, cstr ? std::strlen(cstr) : 0);
+  return decode(codec, cstr, decode_options());
 }
 
 template <typename codec_type, typename string_type>
 typename codec_type::object_type decode(const codec_type &codec, const string_type &string) {
-  return decode(codec, string.data(), string.size());
+  return decode(codec, string, decode_options());
 }
 
 /*
@@ -59,16 +131,121 @@ value_type decode(const char *data, size_t size) {
   return decode(default_codec<value_type>(), data, size);
 }
 
+template <typename value_type>
+value_type decode(const char *data, size_t size, const decode_options &options) {
+  return decode(default_codec<value_type>(), data, size, options);
+}
+
 template <typename value_type>
 value_type decode(const char *cstr) {
   return decode(default_codec<value_type>(), cstr);
 }
 
+template <typename value_type>
+value_type decode(const char *cstr, const decode_options &options) {
+  return decode(default_codec<value_type>(), cstr, options);
+}
+
 template <typename value_type, typename string_type>
 value_type decode(const string_type &string) {
   return decode(default_codec<value_type>(), string);
 }
 
+template <typename value_type, typename string_type>
+value_type decode(const string_type &string, const decode_options &options) {
+  return decode(default_codec<value_type>(), string, options);
+}
+
+/*
+ * json::decode_shared(codec, input)
+ */
+
+/**
+ * Decode input whose ownership is shared with the decoded value. Strings that
+ * are decoded with shared_string_t point into the input instead of being
+ * copied, and keep it alive for as long as they are. The input can be any
+ * buffer with data() and size(), such as std::string, padded_buffer or
+ * mapped_file; padded inputs are decoded with a padded decode_context.
+ */
+template <typename codec_type, typename buffer_type>
+typename codec_type::object_type decode_shared(
+    const codec_type &codec,
+    std::shared_ptr<buffer_type> input) {
+  auto c = detail::make_decode_context(*input);
+  const std::shared_ptr<const void> owner = std::move(input);
+  c.input_owner = &owner;
+  return detail::decode_document(codec, c);
+}
+
+template <typename codec_type>
+typename codec_type::object_type decode_shared(const codec_type &codec, std::string json) {
+  return decode_shared(codec, std::make_shared<const std::string>(std::move(json)));
+}
+
+/*
+ * json::decode_shared(input)
+ */
+
+template <typename value_type, typename buffer_type>
+value_type decode_shared(std::shared_ptr<buffer_type> input) {
+  return decode_shared(default_codec<value_type>(), std::move(input));
+}
+
+template <typename value_type>
+value_type decode_shared(std::string json) {
+  return decode_shared(default_codec<value_type>(), std::move(json));
+}
+
+/*
+ * json::decode_into(codec, data..., &object)
+ */
+
+template <typename codec_type>
+void decode_into(
+    const codec_type &codec,
+    const char *data,
+    size_t size,
+    typename codec_type::object_type &object) {
+  decode_context c(data, data + size);
+  detail::decode_document_into(codec, c, object);
+}
+
+template <typename codec_type>
+void decode_into(
+    const codec_type &codec,
+    const char *cstr,
+    typename codec_type::object_type &object) {
+  decode_into(codec, cstr, cstr ? std::strlen(cstr) : 0, object);
+}
+
+template <typename codec_type, typename string_type>
+void decode_into(
+    const codec_type &codec,
+    const string_type &string,
+    typename codec_type::object_type &object) {
+  auto c = detail::make_decode_context(string);
+  detail::decode_document_into(codec, c, object);
+}
+
+/*
+ * json::decode_into(data..., &object)
+ */
+
+template <typename value_type>
+void decode_into(const char *data, size_t size, value_type &object) {
+  decode_into(default_codec<value_type>(), data, size, object);
+}
+
+template <typename value_type>
+void decode_into(const char *cstr, value_type &object) {
+  decode_into(default_codec<value_type>(), cstr, object);
+}
+
+template <typename value_type, typename string_type>
+void decode_into(const string_type &string, value_type &object) {
+  decode_into(default_codec<value_type>(), string, object);
+}
+
 /*
  * json::try_decode(&object, codec, data...)
  */
@@ -78,24 +255,61 @@ bool try_decode(
     typename codec_type::object_type &object,
     const codec_type &codec,
     const char *data,
-    size_t size) noexcept {
+    size_t size,
+    const decode_options &options) noexcept {
   if (size == 0) {
+    detail::stats_scope failed(detail::stats_operation::decode);
     return false;  // avoid exceptions below
   }
   try {
-    object = decode(codec, data, size);
+    object = decode(codec, data, size, options);
     return true;
   } catch (...) {
     return false;
   }
 }
 
+template <typename codec_type>
+bool try_decode(
+    typename codec_type::object_type &object,
+    const codec_type &codec,
+    const char *cstr,
+    const decode_options &options) noexcept {
+  return try_decode(object, codec, cstr, cstr ? std::strlen(cstr) : 0, options);
+}
+
+template <typename codec_type, typename string_type>
+bool try_decode(
+    typename codec_type::object_type &object,
+    const codec_type &codec,
+    const string_type &string,
+    const decode_options &options) noexcept {
+  if (string.size() == 0) {
+    return try_decode(object, codec, string.data(), 0, options);
+  }
+  try {
+    object = decode(codec, string, options);
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+template <typename codec_type>
+bool try_decode(
+    typename codec_type::object_type &object,
+    const codec_type &codec,
+    const char *data,
+    size_t size) noexcept {
+  return try_decode(object, codec, data, size, decode_options());
+}
+
 template <typename codec_type>
 bool try_decode(
     typename codec_type::object_type &object,
     const codec_type &codec,
     const char *cstr) noexcept {
-  return try_decode(object, codec, cstr, cstr ? std::strlen(cstr) : 0);
+  return try_decode(object, codec, cstr, decode_options());
 }
 
 template <typename codec_type, typename string_type>
@@ -103,7 +317,7 @@ bool try_decode(
     typename codec_type::object_type &object,
     const codec_type &codec,
     const string_type &string) noexcept {
-  return try_decode(object, codec, string.data(), string.size());
+  return try_decode(object, codec, string, decode_options());
 }
 
 /*
@@ -115,15 +329,37 @@ bool try_decode(value_type &object, const char *data, size_t size) noexcept {
   return try_decode(object, default_codec<value_type>(), data, size);
 }
 
+template <typename value_type>
+bool try_decode(
+    value_type &object,
+    const char *data,
+    size_t size,
+    const decode_options &options) noexcept {
+  return try_decode(object, default_codec<value_type>(), data, size, options);
+}
+
 template <typename value_type>
 bool try_decode(value_type &object, const char *cstr) noexcept {
   return try_decode(object, default_codec<value_type>(), cstr);
 }
 
+template <typename value_type>
+bool try_decode(value_type &object, const char *cstr, const decode_options &options) noexcept {
+  return try_decode(object, default_codec<value_type>(), cstr, options);
+}
+
 template <typename value_type, typename string_type>
 bool try_decode(value_type &object, const string_type &string) noexcept {
   return try_decode(object, default_codec<value_type>(), string);
 }
 
+template <typename value_type, typename string_type>
+bool try_decode(
+    value_type &object,
+    const string_type &string,
+    const decode_options &options) noexcept {
+  return try_decode(object, default_codec<value_type>(), string, options);
+}
+
 }  // namespace json
 }  // namespace spotify
@@ -17,13 +17,23 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/detail/cpuid.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/padded_buffer.hpp>
 
 namespace spotify {
 namespace json {
 
+/**
+ * Options for the json::decode and json::try_decode functions, which apply
+ * them to the decode_context that they make.
+ */
+struct decode_options final {
+  bool validate_utf8 = false;  // see decode_context::validate_utf8
+};
+
 /**
  * A decode_context has the information that is kept while decoding JSON with
  * codecs. It has information about the data to read and whether the decoding
@@ -32,6 +42,7 @@ namespace json {
 struct decode_context final {
   decode_context(const char *begin, const char *end);
   decode_context(const char *data, size_t size);
+  explicit decode_context(const padded_string_view &input);
 
   json_force_inline size_t offset() const {
     return (position - begin);
@@ -46,6 +57,28 @@ struct decode_context final {
   }
 
   const bool has_sse42;
+
+  /**
+   * True when at least padded_string_view::padding bytes after end can be
+   * read, which lets the string and whitespace scanners load whole vectors up
+   * to the end of the input.
+   */
+  const bool padded = false;
+
+  /**
+   * When set, the bytes of strings are validated as UTF-8 while they are
+   * scanned, and decoding fails on invalid UTF-8. This covers decoded strings,
+   * object keys and strings inside values that are skipped over.
+   */
+  bool validate_utf8 = false;
+
+  /**
+   * When set, the input is owned by this shared_ptr, and shared_string_t
+   * decodes strings into shared_strings that point into the input and share
+   * its ownership instead of copying them. It is set by decode_shared.
+   */
+  const std::shared_ptr<const void> *input_owner = nullptr;
+
   const char *position;
   const char *const begin;
   const char *const end;
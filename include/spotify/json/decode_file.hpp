@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include <spotify/json/decode.hpp>
+#include <spotify/json/default_codec.hpp>
+#include <spotify/json/mapped_file.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A decoded value together with the mapped file that it was decoded from, for
+ * values that point into the file, such as encoded_value_ref. The value is
+ * valid for as long as the mapped_value lives, also after it is moved.
+ */
+template <typename value_type>
+struct mapped_value final {
+  mapped_file file;
+  value_type value;
+};
+
+/*
+ * json::decode_file(codec, path)
+ */
+
+/**
+ * Decode the file at the path by mapping it into memory, without copying it
+ * into a string first. The mapping is released before returning, so the codec
+ * must not produce values that point into the input; see decode_mapped_file.
+ *
+ * @throws std::system_error if the file can not be opened or mapped.
+ * @throws decode_exception if decoding fails.
+ */
+template <typename codec_type>
+typename codec_type::object_type decode_file(const codec_type &codec, const std::string &path) {
+  const mapped_file file(path);
+  return decode(codec, file);
+}
+
+template <typename value_type>
+value_type decode_file(const std::string &path) {
+  return decode_file(default_codec<value_type>(), path);
+}
+
+/*
+ * json::decode_mapped_file(codec, path)
+ */
+
+/**
+ * Like decode_file, but keeps the file mapped for as long as the returned
+ * value lives, so that the codec can produce values that point into it.
+ */
+template <typename codec_type>
+mapped_value<typename codec_type::object_type> decode_mapped_file(
+    const codec_type &codec,
+    const std::string &path) {
+  mapped_file file(path);
+  auto value = decode(codec, file);
+  return { std::move(file), std::move(value) };
+}
+
+template <typename value_type>
+mapped_value<value_type> decode_mapped_file(const std::string &path) {
+  return decode_mapped_file(default_codec<value_type>(), path);
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -38,6 +38,10 @@ struct bitset_base {
     return (byte_before & mask) >> bidx;
   }
 
+  json_force_inline bool test(const std::size_t index) const {
+    return (_base[index / 8] >> (index & 7)) & 1;
+  }
+
  protected:
   bitset_base(const std::size_t size, uint8_t *inline_base);
 
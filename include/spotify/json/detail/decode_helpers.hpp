@@ -20,7 +20,9 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <spotify/json/decode_context.hpp>
@@ -184,6 +186,33 @@ json_force_inline void decode_object(decode_context &context, const callback_fun
   });
 }
 
+/**
+ * Like decode_object, for an object whose opening brace and first key/value
+ * pair have already been read by the caller, as variant_t does when its
+ * discriminator is the first key. The context must be right after the first
+ * value.
+ */
+template <typename key_codec_type, typename callback_function>
+json_never_inline void decode_object_after_first_member(
+    decode_context &context,
+    const callback_function &callback) {
+  auto codec = key_codec_type();
+  skip_any_whitespace(context);
+
+  while (json_likely(peek(context) != '}')) {
+    skip_1(context, ',');
+    skip_any_whitespace(context);
+    auto key = codec.decode(context);
+    skip_any_whitespace(context);
+    skip_1(context, ':');
+    skip_any_whitespace(context);
+    callback(std::move(key));
+    skip_any_whitespace(context);
+  }
+
+  context.position++;
+}
+
 json_force_inline void skip_true(decode_context &context) {
   skip_4(context, "true");
 }
@@ -197,6 +226,163 @@ json_force_inline void skip_null(decode_context &context) {
   skip_4(context, "null");
 }
 
+/**
+ * Bit flags for the different kinds of JSON values, as identified by the first
+ * byte of their encoding. Codecs can optionally declare which kinds of values
+ * they are able to decode (see codec_interface.hpp), which allows codecs that
+ * choose between several inner codecs (one_of_t, empty_as_t) to dispatch on the
+ * next byte of the input instead of trying each codec and catching exceptions.
+ */
+using token_mask = uint8_t;
+
+constexpr token_mask token_none = 0;
+constexpr token_mask token_object = (1 << 0);
+constexpr token_mask token_array = (1 << 1);
+constexpr token_mask token_string = (1 << 2);
+constexpr token_mask token_number = (1 << 3);
+constexpr token_mask token_boolean = (1 << 4);
+constexpr token_mask token_null = (1 << 5);
+constexpr token_mask token_any = 0x3F;
+
+/**
+ * Classify the value that starts at the current position of the context. The
+ * '+' and '.' characters are not valid starts of JSON numbers, but they are
+ * classified as numbers anyway since the floating point codecs accept them.
+ * Any other unexpected character, or the end of the input, yields token_none.
+ */
+json_force_inline token_mask peek_token(const decode_context &context) {
+  switch (peek(context)) {
+    case '{': return token_object;
+    case '[': return token_array;
+    case '"': return token_string;
+    case 't': return token_boolean;
+    case 'f': return token_boolean;
+    case 'n': return token_null;
+    case '-': case '+': case '.':  // fallthrough
+    case '0': case '1': case '2': case '3': case '4':  // fallthrough
+    case '5': case '6': case '7': case '8': case '9': return token_number;
+    default: return token_none;
+  }
+}
+
+template <typename T>
+struct has_accepted_tokens_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<U>().accepted_tokens(),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Returns the kinds of JSON values that a codec is able to decode. Codecs that
+ * do not have an accepted_tokens() method are assumed to accept anything.
+ */
+template <typename codec_type>
+typename std::enable_if<!has_accepted_tokens_method<codec_type>::value, token_mask>::type
+json_force_inline accepted_tokens(const codec_type & /*codec*/) {
+  return token_any;
+}
+
+template <typename codec_type>
+typename std::enable_if<has_accepted_tokens_method<codec_type>::value, token_mask>::type
+json_force_inline accepted_tokens(const codec_type &codec) {
+  return codec.accepted_tokens();
+}
+
+template <typename T>
+struct has_decode_into_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<U>().decode_into(
+          std::declval<decode_context &>(),
+          std::declval<typename U::object_type &>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+template <typename codec_type, typename value_type>
+struct can_decode_into : std::integral_constant<bool,
+    has_decode_into_method<codec_type>::value &&
+    std::is_same<value_type, typename codec_type::object_type>::value> {};
+
+/**
+ * Decode into an existing value, reusing the memory that it has already
+ * allocated when the codec supports that. Codecs that do not have a
+ * decode_into() method, or that decode another type than that of the value,
+ * decode a new value and assign it.
+ */
+template <typename codec_type, typename value_type>
+typename std::enable_if<!can_decode_into<codec_type, value_type>::value>::type
+json_force_inline decode_into(const codec_type &codec, decode_context &context, value_type &value) {
+  value = codec.decode(context);
+}
+
+template <typename codec_type, typename value_type>
+typename std::enable_if<can_decode_into<codec_type, value_type>::value>::type
+json_force_inline decode_into(const codec_type &codec, decode_context &context, value_type &value) {
+  codec.decode_into(context, value);
+}
+
+template <typename T>
+struct has_decode_after_first_member_method {
+  template <typename U>
+  static auto test(int) -> decltype(
+      std::declval<U>().decode_after_first_member(std::declval<decode_context &>()),
+      std::true_type());
+
+  template <typename>
+  static std::false_type test(...);
+
+ public:
+  static constexpr bool value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+};
+
+/**
+ * Decode an object whose opening brace, at object_begin, and first key/value
+ * pair have already been read, without reading them again when the codec has
+ * a decode_after_first_member() method. Other codecs decode the whole object
+ * again from object_begin.
+ */
+template <typename codec_type>
+json_force_inline typename codec_type::object_type decode_after_first_member(
+    const codec_type &codec,
+    decode_context &context,
+    const char *object_begin) {
+  if constexpr (has_decode_after_first_member_method<codec_type>::value) {
+    return codec.decode_after_first_member(context);
+  } else {
+    context.position = object_begin;
+    return codec.decode(context);
+  }
+}
+
+/**
+ * Reset a value to a copy of prototype, the value that decode would have left
+ * it with. Copy assignment lets strings and containers keep the memory that
+ * they have allocated. Values that can not be copied are assigned a default
+ * constructed value instead, and are left as they are if they can not be
+ * default constructed either.
+ */
+template <typename value_type>
+json_force_inline void reset_value(value_type &value, const value_type &prototype) {
+  if constexpr (std::is_copy_assignable<value_type>::value) {
+    value = prototype;
+  } else if constexpr (std::is_default_constructible<value_type>::value) {
+    value = value_type();
+  }
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -29,6 +29,9 @@ namespace detail {
  * backslashes and quotation marks.
  *
  * See: http://www.ietf.org/rfc/rfc4627.txt (Section 2.5)
+ *
+ * When context.validate_utf8 is set, the string is also validated as UTF-8
+ * while it is escaped, and encode_exception is thrown if it is not.
  */
 void write_escaped(encode_context &context, const char *begin, const char *end);
 
@@ -40,11 +40,21 @@ struct field {
   virtual ~field() = default;
 
   virtual void decode(decode_context &context, void *object) const = 0;
+  virtual void decode_into(decode_context &context, void *object) const {
+    decode(context, object);
+  }
   virtual void encode(
       encode_context &context,
       const std::string &escaped_key,
       const void *object) const = 0;
 
+  /**
+   * Reset the value of the field to its value in prototype, an object made
+   * like decode makes them, for fields that decode_into did not find in the
+   * input.
+   */
+  virtual void reset(void * /*object*/, const void * /*prototype*/) const {}
+
   json_force_inline bool is_required() const { return (_data != json_size_t_max); }
   json_force_inline size_t required_field_idx() const { return _data; }
 
@@ -56,7 +66,7 @@ struct field {
 class field_registry final {
  public:
   using field_vec = std::vector<std::pair<std::string, std::shared_ptr<const field>>>;
-  using field_map = std::unordered_map<std::string, std::shared_ptr<const field>>;
+  using field_map = std::unordered_map<std::string, size_t>;  // name -> index in field_vec
   using const_iterator = typename field_vec::const_iterator;
 
   field_registry();
@@ -72,6 +82,14 @@ class field_registry final {
   const field *find(const std::string &name) const noexcept;
   size_t num_required_fields() const noexcept { return _num_required_fields; }
 
+  /**
+   * The index of the field in the order that the fields were saved in, or
+   * json_size_t_max if there is no field with the name.
+   */
+  size_t find_index(const std::string &name) const noexcept;
+  const field &at(size_t index) const noexcept { return *_field_list[index].second; }
+  size_t size() const noexcept { return _field_list.size(); }
+
  private:
   field_vec _field_list;
   field_map _fields;
@@ -18,35 +18,87 @@
 
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/slow_path_counters.hpp>
 
 namespace spotify {
 namespace json {
 namespace detail {
 
 void skip_any_simple_characters_scalar(decode_context &context);
+void skip_any_simple_characters_utf8_scalar(decode_context &context);
 #if defined(json_arch_x86_sse42)
 void skip_any_simple_characters_sse42(decode_context &context);
+void skip_any_simple_characters_utf8_sse42(decode_context &context);
+void skip_any_simple_characters_padded_sse42(decode_context &context);
 #endif  // defined(json_arch_x86_sse42)
 
+/**
+ * Like skip_any_simple_characters, but also validates the skipped bytes as
+ * UTF-8, failing the decoding if they are not.
+ */
+json_force_inline void skip_any_simple_characters_utf8(decode_context &context) {
+#if defined(json_arch_x86_sse42)
+  if (json_likely(context.has_sse42)) {
+    return skip_any_simple_characters_utf8_sse42(context);
+  }
+#endif  // defined(json_arch_x86_sse42)
+  json_count_slow_path(scalar_fallback);
+  return skip_any_simple_characters_utf8_scalar(context);
+}
+
 /**
  * Skip past the bytes of the string until either a " or a \ character is
  * found. This method attempts to skip as large chunks of memory as possible
  * at each step, by making sure that the context position is aligned to the
  * appropriate address and then reading and comparing several bytes in a
- * single read operation.
+ * single read operation. When context.validate_utf8 is set, the skipped bytes
+ * are validated in the same pass.
  */
 json_force_inline void skip_any_simple_characters(decode_context &context) {
+  if (json_unlikely(context.validate_utf8)) {
+    return skip_any_simple_characters_utf8(context);
+  }
 #if defined(json_arch_x86_sse42)
   if (json_likely(context.has_sse42)) {
+    if (context.padded) {
+      return skip_any_simple_characters_padded_sse42(context);
+    }
     return skip_any_simple_characters_sse42(context);
   }
 #endif  // defined(json_arch_x86_sse42)
+  json_count_slow_path(scalar_fallback);
   return skip_any_simple_characters_scalar(context);
 }
 
+void copy_any_simple_characters_scalar(decode_context &context, char *&out);
+#if defined(json_arch_x86_sse42)
+void copy_any_simple_characters_sse42(decode_context &context, char *&out);
+void copy_any_simple_characters_padded_sse42(decode_context &context, char *&out);
+#endif  // defined(json_arch_x86_sse42)
+
+/**
+ * Like skip_any_simple_characters, but also copies the skipped bytes to out
+ * and advances out past them. The copy is done in the same pass, 16 bytes at
+ * a time, so out must have room for 16 bytes more than the number of bytes
+ * that are copied. The bytes are not validated as UTF-8.
+ */
+json_force_inline void copy_any_simple_characters(decode_context &context, char *&out) {
+#if defined(json_arch_x86_sse42)
+  if (json_likely(context.has_sse42)) {
+    if (context.padded) {
+      return copy_any_simple_characters_padded_sse42(context, out);
+    }
+    return copy_any_simple_characters_sse42(context, out);
+  }
+#endif  // defined(json_arch_x86_sse42)
+  json_count_slow_path(scalar_fallback);
+  return copy_any_simple_characters_scalar(context, out);
+}
+
 void skip_any_whitespace_scalar(decode_context &context);
 #if defined(json_arch_x86_sse42)
 void skip_any_whitespace_sse42(decode_context &context);
+void skip_any_whitespace_padded_sse42(decode_context &context);
 #endif  // defined(json_arch_x86_sse42)
 
 /**
@@ -59,9 +111,13 @@ void skip_any_whitespace_sse42(decode_context &context);
 json_force_inline void skip_any_whitespace(decode_context &context) {
 #if defined(json_arch_x86_sse42)
   if (json_likely(context.has_sse42)) {
+    if (context.padded) {
+      return skip_any_whitespace_padded_sse42(context);
+    }
     return skip_any_whitespace_sse42(context);
   }
 #endif  // defined(json_arch_x86_sse42)
+  json_count_slow_path(scalar_fallback);
   skip_any_whitespace_scalar(context);
 }
 
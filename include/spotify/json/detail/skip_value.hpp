@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include <spotify/json/decode_context.hpp>
 
 namespace spotify {
@@ -31,6 +33,20 @@ namespace detail {
  */
 void skip_value(decode_context &context);
 
+/**
+ * Count the elements of the JSON array that starts at context.position,
+ * without decoding them. The context is not modified. The count is meant as a
+ * hint: it is 0 if the array is not terminated, and it may be wrong for
+ * invalid JSON.
+ */
+size_t count_array_elements(const decode_context &context);
+
+/**
+ * Count the key/value pairs of the JSON object that starts at
+ * context.position, like count_array_elements counts the elements of arrays.
+ */
+size_t count_object_members(const decode_context &context);
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
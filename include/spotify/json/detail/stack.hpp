@@ -22,6 +22,7 @@
 #include <memory>
 #include <vector>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/slow_path_counters.hpp>
 
 namespace spotify {
 namespace json {
@@ -35,6 +36,7 @@ struct stack {
     } else if (json_likely(_inline_size < inline_capacity)) {
       _array[_inline_size++] = std::move(value);
     } else {
+      json_count_slow_path(stack_spill);
       _vector.reset(new std::vector<T>(_array.begin(), _array.end()));
       _vector->push_back(std::move(value));
     }
@@ -22,6 +22,7 @@
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/encode_context.hpp>
 #include <spotify/json/encoded_value.hpp>
+#include <spotify/json/stats.hpp>
 
 namespace spotify {
 namespace json {
@@ -29,12 +30,28 @@ namespace json {
 template <typename codec_type, typename object_type>
 json_never_inline std::string encode(
     const codec_type &codec,
-    const object_type &object) {
+    const object_type &object,
+    const encode_options &options) {
+  detail::stats_scope stats(detail::stats_operation::encode);
   encode_context context;
+  context.validate_utf8 = options.validate_utf8;
   codec.encode(context, object);
+  stats.succeeded(context.size());
   return std::string(context.data(), context.size());
 }
 
+template <typename codec_type, typename object_type>
+json_never_inline std::string encode(
+    const codec_type &codec,
+    const object_type &object) {
+  return encode(codec, object, encode_options());
+}
+
+template <typename object_type>
+json_never_inline std::string encode(const object_type &object, const encode_options &options) {
+  return encode(default_codec<object_type>(), object, options);
+}
+
 template <typename object_type>
 json_never_inline std::string encode(const object_type &object) {
   return encode(default_codec<object_type>(), object);
@@ -44,8 +61,10 @@ template <typename codec_type, typename value_type>
 json_never_inline encoded_value encode_value(
     const codec_type &codec,
     const value_type &value) {
+  detail::stats_scope stats(detail::stats_operation::encode);
   encode_context context;
   codec.encode(context, value);
+  stats.succeeded(context.size());
   return encoded_value(std::move(context), encoded_value::unsafe_unchecked());
 }
 
@@ -26,6 +26,14 @@
 namespace spotify {
 namespace json {
 
+/**
+ * Options for the json::encode function, which applies them to the
+ * encode_context that it makes.
+ */
+struct encode_options final {
+  bool validate_utf8 = false;  // see encode_context::validate_utf8
+};
+
 /**
  * An encode_context has the information that is kept while encoding JSON with
  * codecs. It keeps a buffer of data that can be expanded and written to.
@@ -89,6 +97,12 @@ struct encode_context final {
 
   const bool has_sse42;
 
+  /**
+   * When set, strings are validated as UTF-8 while they are escaped, and
+   * encoding fails on invalid UTF-8.
+   */
+  bool validate_utf8 = false;
+
  private:
   char * grow_buffer(const std::size_t num_bytes);
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The cost of decoding or encoding one field of object_t codecs, summed over
+ * all calls. Time includes the fields of nested objects; self time does not.
+ */
+struct field_profile_counters final {
+  uint64_t calls = 0;
+  uint64_t bytes = 0;  // of JSON, for the value of the field
+  uint64_t nanoseconds = 0;
+  uint64_t self_nanoseconds = 0;
+};
+
+/**
+ * A field is identified by its path: the names of the fields that lead to it
+ * from the outermost object, separated by dots. For example, the artists of
+ * the tracks of a playlist are "tracks.artists", whether tracks is an object
+ * or an array of objects.
+ */
+struct field_profile_entry final {
+  std::string path;
+  field_profile_counters decode;
+  field_profile_counters encode;
+};
+
+/**
+ * Turn field profiling on or off. It is off by default. While it is on, every
+ * field that object_t decodes or encodes is timed and recorded, which makes
+ * decoding and encoding objects considerably slower; it is meant to find out
+ * where the time goes, not to be left on. While it is off, object_t only
+ * checks a flag once per object.
+ */
+void set_field_profiling(bool enabled);
+
+/**
+ * The fields recorded since the program started or reset_field_profile was
+ * last called, from all threads, sorted by path.
+ */
+std::vector<field_profile_entry> read_field_profile();
+
+void reset_field_profile();
+
+/**
+ * Write a table of the recorded fields, the most expensive first, with each
+ * field's share of the total decode and encode time.
+ */
+void dump_field_profile(std::ostream &stream);
+
+namespace detail {
+
+extern std::atomic<bool> field_profiling;
+
+json_force_inline bool field_profiling_enabled() {
+  return field_profiling.load(std::memory_order_relaxed);
+}
+
+enum class field_profile_operation {
+  decode,
+  encode
+};
+
+/**
+ * Times the decoding or encoding of one field. The field is recorded when
+ * finish is called; if it is not, for example because decoding failed with an
+ * exception, the scope ends without recording anything.
+ */
+class field_profile_scope final {
+ public:
+  field_profile_scope(field_profile_operation operation, const char *name, size_t name_size);
+  ~field_profile_scope();
+
+  void finish(size_t bytes);
+
+ private:
+  const field_profile_operation _operation;
+  std::chrono::steady_clock::time_point _start;
+  bool _finished = false;
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -19,9 +19,17 @@
 #include <spotify/json/codec.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
+#include <spotify/json/decode_file.hpp>
 #include <spotify/json/decode_context.hpp>
 #include <spotify/json/default_codec.hpp>
 #include <spotify/json/encode.hpp>
 #include <spotify/json/encode_exception.hpp>
 #include <spotify/json/encode_context.hpp>
 #include <spotify/json/encoded_value.hpp>
+#include <spotify/json/field_profile.hpp>
+#include <spotify/json/mapped_file.hpp>
+#include <spotify/json/padded_buffer.hpp>
+#include <spotify/json/shared_string.hpp>
+#include <spotify/json/slow_path_counters.hpp>
+#include <spotify/json/stats.hpp>
+#include <spotify/json/unknown_fields.hpp>
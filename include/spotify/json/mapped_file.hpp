@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <spotify/json/padded_buffer.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A file that is mapped read-only into memory, so that it can be decoded
+ * without first being read into a string. The mapping is followed by at least
+ * padded_string_view::padding readable zero bytes, so decoding it takes the
+ * padded fast paths, and it is hinted to the kernel for sequential reading.
+ *
+ * The mapping stays valid when the mapped_file is moved, so values that point
+ * into it (such as encoded_value_ref) stay valid for as long as it lives. The
+ * file must not be truncated while it is mapped.
+ *
+ * Where memory mapping is not available, the file is read into a buffer.
+ */
+class mapped_file final {
+ public:
+  /**
+   * @throws std::system_error if the file can not be opened or mapped.
+   */
+  explicit mapped_file(const std::string &path);
+  mapped_file(mapped_file &&file) noexcept;
+  mapped_file(const mapped_file &) = delete;
+  ~mapped_file();
+
+  mapped_file &operator=(mapped_file &&file) noexcept;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  const char *data() const { return _data; }
+  size_t size() const { return _size; }
+
+  operator padded_string_view() const {
+    return padded_string_view(_data, _size);
+  }
+
+ private:
+  void unmap();
+
+  const char *_data = nullptr;
+  size_t _size = 0;
+  size_t _mapped_size = 0;
+#if defined(_WIN32)
+  padded_buffer _buffer;
+#endif  // defined(_WIN32)
+};
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace spotify {
+namespace json {
+
+/**
+ * JSON input that is followed by at least padding bytes that may be read,
+ * although they are not part of the input. A decode_context made from padded
+ * input uses SIMD kernels that load full vectors all the way to the end of the
+ * input instead of finishing with a byte by byte loop, which makes scanning
+ * strings and whitespace cheaper. The padding bytes can have any value.
+ *
+ * padded_string_view does not own the data; see padded_buffer.
+ */
+class padded_string_view final {
+ public:
+  static constexpr size_t padding = 16;
+
+  /**
+   * The caller promises that the padding bytes after data + size can be read.
+   */
+  padded_string_view(const char *data, const size_t size)
+      : _data(data),
+        _size(size) {}
+
+  const char *data() const { return _data; }
+  size_t size() const { return _size; }
+
+ private:
+  const char *_data;
+  size_t _size;
+};
+
+/**
+ * An owning buffer for JSON input, allocated with padded_string_view::padding
+ * zeroed bytes after its end.
+ */
+class padded_buffer final {
+ public:
+  padded_buffer()
+      : padded_buffer(0) {}
+
+  explicit padded_buffer(const size_t size)
+      : _data(new char[size + padded_string_view::padding]),
+        _size(size) {
+    std::memset(_data.get() + size, 0, padded_string_view::padding);
+  }
+
+  padded_buffer(const char *data, const size_t size)
+      : padded_buffer(size) {
+    std::memcpy(_data.get(), data, size);
+  }
+
+  explicit padded_buffer(const std::string &string)
+      : padded_buffer(string.data(), string.size()) {}
+
+  char *data() { return _data.get(); }
+  const char *data() const { return _data.get(); }
+  size_t size() const { return _size; }
+
+  operator padded_string_view() const {
+    return padded_string_view(_data.get(), _size);
+  }
+
+ private:
+  std::unique_ptr<char[]> _data;
+  size_t _size;
+};
+
+}  // namespace json
+}  // namespace spotify
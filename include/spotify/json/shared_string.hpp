@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace spotify {
+namespace json {
+
+/**
+ * An immutable string that shares ownership of the memory it points to. When
+ * decoded with decode_shared, strings without escape sequences point into the
+ * input buffer and keep it alive, so decoded values can be kept around after
+ * decoding without copying each string. Strings that do not point into a
+ * shared buffer own a copy of their characters.
+ *
+ * Copying a shared_string copies a shared_ptr. Note that a single
+ * shared_string that is kept alive keeps the whole input buffer alive.
+ */
+class shared_string final {
+ public:
+  shared_string() = default;
+
+  explicit shared_string(std::string string) {
+    const auto owned = std::make_shared<const std::string>(std::move(string));
+    _data = std::shared_ptr<const char>(owned, owned->data());
+    _size = owned->size();
+  }
+
+  /**
+   * A string of size characters at data, that are kept alive by owner.
+   */
+  shared_string(const std::shared_ptr<const void> &owner, const char *data, size_t size)
+      : _data(owner, data),
+        _size(size) {}
+
+  const char *data() const { return _data.get(); }
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+
+  const char *begin() const { return data(); }
+  const char *end() const { return data() + _size; }
+
+  std::string_view view() const {
+    return std::string_view(data(), _size);
+  }
+
+  operator std::string_view() const {
+    return view();
+  }
+
+  std::string str() const {
+    return std::string(data(), _size);
+  }
+
+ private:
+  std::shared_ptr<const char> _data;
+  size_t _size = 0;
+};
+
+inline bool operator==(const shared_string &a, const shared_string &b) { return a.view() == b.view(); }
+inline bool operator!=(const shared_string &a, const shared_string &b) { return a.view() != b.view(); }
+inline bool operator<(const shared_string &a, const shared_string &b) { return a.view() < b.view(); }
+inline bool operator==(const shared_string &a, std::string_view b) { return a.view() == b; }
+inline bool operator!=(const shared_string &a, std::string_view b) { return a.view() != b; }
+inline bool operator==(std::string_view a, const shared_string &b) { return a == b.view(); }
+inline bool operator!=(std::string_view a, const shared_string &b) { return a != b.view(); }
+
+inline std::ostream &operator<<(std::ostream &stream, const shared_string &string) {
+  return stream << string.view();
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace spotify {
+namespace json {
+
+/**
+ * The slow paths of the library that are counted when it is built with the
+ * SPOTIFY_JSON_USE_SLOW_PATH_COUNTERS compile time flag (the CMake option of
+ * the same name). When it is off, nothing is counted and there is no cost.
+ */
+enum class slow_path {
+  decode_integer_tricky,  // integers with too many digits, or exponents or fractions
+  decode_escaped_string,  // strings with escape sequences
+  stack_spill,            // detail::stack outgrowing its inline capacity
+  bitset_spill,           // objects with more required fields than fit inline
+  grow_buffer,            // encode_context reallocating its buffer
+  scalar_fallback,        // string and whitespace scanning without SSE 4.2
+  num_slow_paths
+};
+
+#if defined(SPOTIFY_JSON_USE_SLOW_PATH_COUNTERS)
+constexpr bool slow_path_counters_enabled = true;
+#else
+constexpr bool slow_path_counters_enabled = false;
+#endif  // defined(SPOTIFY_JSON_USE_SLOW_PATH_COUNTERS)
+
+const char *slow_path_name(slow_path path);
+
+struct slow_path_counts final {
+  uint64_t operator[](const slow_path path) const {
+    return counts[static_cast<size_t>(path)];
+  }
+
+  std::array<uint64_t, static_cast<size_t>(slow_path::num_slow_paths)> counts{};
+};
+
+/**
+ * The number of times that each slow path was taken since the program started,
+ * summed over all threads. Like read_stats, the counts are kept per thread and
+ * only summed up here.
+ */
+slow_path_counts read_slow_path_counters();
+
+namespace detail {
+
+void count_slow_path(slow_path path);
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#if defined(SPOTIFY_JSON_USE_SLOW_PATH_COUNTERS)
+#define json_count_slow_path(path) \
+  ::spotify::json::detail::count_slow_path(::spotify::json::slow_path::path)
+#else
+#define json_count_slow_path(path) ((void)0)
+#endif  // defined(SPOTIFY_JSON_USE_SLOW_PATH_COUNTERS)
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * True if decode, decode_into, try_decode, encode and encode_value record
+ * statistics. This is controlled by the SPOTIFY_JSON_USE_STATS compile time
+ * flag (the CMake option of the same name). When it is off, the functions are
+ * not instrumented at all and read_stats() always returns zeros.
+ */
+#if defined(SPOTIFY_JSON_USE_STATS)
+constexpr bool stats_enabled = true;
+#else
+constexpr bool stats_enabled = false;
+#endif  // defined(SPOTIFY_JSON_USE_STATS)
+
+/**
+ * A histogram of latencies in nanoseconds with logarithmic buckets. Every power
+ * of two is split into 8 linear sub-buckets, so a latency is known to within
+ * 12.5%. Latencies of 2^40 ns (about 18 minutes) or more share the last bucket.
+ */
+class latency_histogram final {
+ public:
+  static constexpr size_t sub_bucket_bits = 3;
+  static constexpr size_t max_exponent = 40;
+  static constexpr size_t num_buckets = (max_exponent - (sub_bucket_bits - 1)) << sub_bucket_bits;
+
+  static size_t bucket(uint64_t nanoseconds);
+  static uint64_t bucket_lower_bound(size_t bucket);
+
+  uint64_t count() const;
+
+  /**
+   * The latency below which the given fraction (between 0 and 1) of the
+   * recorded latencies fall, rounded down to the lower bound of its bucket.
+   */
+  uint64_t percentile(double fraction) const;
+
+  std::array<uint64_t, num_buckets> counts{};
+};
+
+struct operation_stats final {
+  uint64_t documents = 0;  // successful calls
+  uint64_t bytes = 0;      // bytes of JSON decoded or encoded by successful calls
+  uint64_t failures = 0;   // calls that failed with an exception
+  latency_histogram latency;  // of all calls, successful or not
+};
+
+struct stats final {
+  operation_stats decode;
+  operation_stats encode;
+};
+
+/**
+ * The statistics of all threads since the program started. Each thread records
+ * into counters of its own, without synchronization; read_stats sums them up,
+ * so it is more expensive than recording and is meant to be called from time to
+ * time by a metrics exporter. The counters only ever grow; report the
+ * difference between two reads to get rates.
+ */
+stats read_stats();
+
+namespace detail {
+
+enum class stats_operation {
+  decode,
+  encode
+};
+
+void record_stats(stats_operation operation, size_t bytes, bool failed, uint64_t nanoseconds);
+
+#if defined(SPOTIFY_JSON_USE_STATS)
+
+/**
+ * Times one call to decode or encode. The call is counted as successful if
+ * succeeded is called before the scope ends, and as failed otherwise, for
+ * example when an exception is thrown.
+ */
+class stats_scope final {
+ public:
+  explicit stats_scope(const stats_operation operation)
+      : _operation(operation),
+        _start(std::chrono::steady_clock::now()) {}
+
+  ~stats_scope() {
+    if (json_unlikely(!_recorded)) {
+      record(0, true);
+    }
+  }
+
+  void succeeded(const size_t bytes) {
+    record(bytes, false);
+  }
+
+ private:
+  void record(const size_t bytes, const bool failed) {
+    using namespace std::chrono;
+    _recorded = true;
+    const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - _start);
+    record_stats(_operation, bytes, failed, uint64_t(elapsed.count()));
+  }
+
+  const stats_operation _operation;
+  const std::chrono::steady_clock::time_point _start;
+  bool _recorded = false;
+};
+
+#else
+
+class stats_scope final {
+ public:
+  explicit stats_scope(const stats_operation /*operation*/) {}
+  void succeeded(const size_t /*bytes*/) {}
+};
+
+#endif  // defined(SPOTIFY_JSON_USE_STATS)
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
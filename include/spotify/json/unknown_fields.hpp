@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <spotify/json/encoded_value.hpp>
+
+namespace spotify {
+namespace json {
+
+/**
+ * A key/value pair of an object that its object_t codec has no field for, as
+ * captured by object_t::capture_unknown_fields. Both point into the input
+ * without copying it: key is the key as it is in the input, with its quotes and
+ * escape sequences, and value is the encoded value. They are only valid for as
+ * long as the input is.
+ */
+struct unknown_field {
+  encoded_value_ref key;
+  encoded_value_ref value;
+};
+
+using unknown_fields = std::vector<unknown_field>;
+
+}  // namespace json
+}  // namespace spotify
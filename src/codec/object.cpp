@@ -16,6 +16,12 @@
 
 #include <spotify/json/codec/object.hpp>
 
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <spotify/json/field_profile.hpp>
+
 namespace spotify {
 namespace json {
 namespace codec {
@@ -27,36 +33,338 @@ object_t_base::object_t_base(object_t_base &&) = default;
 object_t_base::object_t_base(const object_t_base &) = default;
 object_t_base::~object_t_base() = default;
 
-void object_t_base::decode(decode_context &context, void *value) const {
+namespace {
+
+/**
+ * An object key as decoded by raw_key_t: the unescaped name, and where the key
+ * is in the input, with its quotes.
+ */
+struct raw_key {
+  std::string name;
+  const char *begin;
+  const char *end;
+};
+
+/**
+ * Key codec for decode_object that also records where each key is, for
+ * capturing unknown fields verbatim.
+ */
+class raw_key_t final {
+ public:
+  raw_key decode(decode_context &context) const {
+    const auto begin = context.position;
+    auto name = string_t().decode(context);
+    return raw_key{ std::move(name), begin, context.position };
+  }
+};
+
+const std::string &key_name(const std::string &key) {
+  return key;
+}
+
+const std::string &key_name(const raw_key &key) {
+  return key.name;
+}
+
+/**
+ * Decode the fields of an object. find_field returns the field for a key, or
+ * nullptr if the value of the key is not decoded by a field, in which case
+ * unknown_field is called to skip or capture it. The bitset of seen fields is
+ * sized for all required fields of the codec, since the required fields that
+ * find_field can return need not have contiguous indices. When
+ * after_first_member is set, the object has been read up to after its first
+ * value, see decode_object_after_first_member.
+ */
+template <
+    typename key_codec_type,
+    typename find_field_function,
+    typename decode_field_function,
+    typename unknown_field_function>
+void decode_fields(
+    decode_context &context,
+    const detail::field_registry &fields,
+    const size_t num_required_fields,
+    find_field_function find_field,
+    decode_field_function decode_field,
+    unknown_field_function unknown_field,
+    const bool after_first_member) {
   uint_fast32_t uniq_seen_required = 0;
-  detail::bitset<64> seen_required(_fields.num_required_fields());
+  detail::bitset<64> seen_required(fields.num_required_fields());
 
-  detail::decode_object<string_t>(context, [&](const std::string &key) {
-    const auto *field = _fields.find(key);
+  const auto decode_member = [&](const auto &key) {
+    const auto *field = find_field(key_name(key));
     if (json_unlikely(!field)) {
-      return detail::skip_value(context);
+      return unknown_field(key);
     }
 
-    field->decode(context, value);
+    decode_field(key_name(key), *field);
     if (field->is_required()) {
       const auto seen = seen_required.test_and_set(field->required_field_idx());
       uniq_seen_required += (1 - seen);  // 'seen' is 1 when the field is a duplicate; 0 otherwise
     }
-  });
+  };
+
+  if (json_unlikely(after_first_member)) {
+    detail::decode_object_after_first_member<key_codec_type>(context, decode_member);
+  } else {
+    detail::decode_object<key_codec_type>(context, decode_member);
+  }
 
-  const auto is_missing_req_fields = (uniq_seen_required != _fields.num_required_fields());
+  const auto is_missing_req_fields = (uniq_seen_required != num_required_fields);
   detail::fail_if(context, is_missing_req_fields, "Missing required field(s)");
 }
 
+auto skip_unknown_field(decode_context &context) {
+  return [&context](const std::string &) { detail::skip_value(context); };
+}
+
+auto capture_unknown_field(decode_context &context, unknown_fields &captured) {
+  return [&context, &captured](const raw_key &key) {
+    const auto begin = context.position;
+    detail::skip_value(context);
+    captured.push_back(unknown_field{
+        encoded_value_ref(key.begin, size_t(key.end - key.begin), encoded_value_ref::unsafe_unchecked()),
+        encoded_value_ref(begin, size_t(context.position - begin), encoded_value_ref::unsafe_unchecked()) });
+  };
+}
+
+/**
+ * Wrap a decode_field function for decode_fields so that it records the cost
+ * of each field in the field profile.
+ */
+template <typename decode_field_function>
+auto profile_decode_field(decode_context &context, decode_field_function decode_field) {
+  return [&context, decode_field](const std::string &key, const detail::field &field) {
+    detail::field_profile_scope scope(detail::field_profile_operation::decode, key.data(), key.size());
+    const auto begin = context.position;
+    decode_field(key, field);
+    scope.finish(context.position - begin);
+  };
+}
+
+/**
+ * Decode the fields of an object, recording them in the field profile if
+ * field profiling is enabled.
+ */
+template <
+    typename key_codec_type,
+    typename find_field_function,
+    typename decode_field_function,
+    typename unknown_field_function>
+void decode_fields_maybe_profiled(
+    decode_context &context,
+    const detail::field_registry &fields,
+    const size_t num_required_fields,
+    find_field_function find_field,
+    decode_field_function decode_field,
+    unknown_field_function unknown_field,
+    const bool after_first_member = false) {
+  if (json_unlikely(detail::field_profiling_enabled())) {
+    const auto profiled = profile_decode_field(context, decode_field);
+    decode_fields<key_codec_type>(
+        context, fields, num_required_fields, find_field, profiled, unknown_field, after_first_member);
+  } else {
+    decode_fields<key_codec_type>(
+        context, fields, num_required_fields, find_field, decode_field, unknown_field, after_first_member);
+  }
+}
+
+/**
+ * Decode the fields of an object, capturing unknown fields into the member
+ * that capture selects, if the codec has one, and skipping them otherwise.
+ */
+template <typename unknown_fields_type, typename find_field_function, typename decode_field_function>
+void decode_fields_maybe_capturing(
+    decode_context &context,
+    const detail::field_registry &fields,
+    const unknown_fields_type *capture,
+    void *value,
+    find_field_function find_field,
+    decode_field_function decode_field,
+    const bool after_first_member = false) {
+  const auto num_required_fields = fields.num_required_fields();
+  if (json_unlikely(capture != nullptr)) {
+    auto &captured = capture->get(value);
+    captured.clear();
+    decode_fields_maybe_profiled<raw_key_t>(
+        context,
+        fields,
+        num_required_fields,
+        find_field,
+        decode_field,
+        capture_unknown_field(context, captured),
+        after_first_member);
+  } else {
+    decode_fields_maybe_profiled<string_t>(
+        context,
+        fields,
+        num_required_fields,
+        find_field,
+        decode_field,
+        skip_unknown_field(context),
+        after_first_member);
+  }
+}
+
+/**
+ * Encode a field, recording it in the field profile. The name of the field is
+ * taken from its escaped key, "name": with quotes and colon.
+ */
+void encode_field_profiled(
+    encode_context &context,
+    const std::string &escaped_key,
+    const detail::field &field,
+    const void *value) {
+  detail::field_profile_scope scope(
+      detail::field_profile_operation::encode,
+      escaped_key.data() + 1,
+      escaped_key.size() - 3);
+  const auto begin = context.size();
+  field.encode(context, escaped_key, value);
+  scope.finish(context.size() - begin);
+}
+
+}  // namespace
+
+void object_t_base::decode(decode_context &context, void *value) const {
+  decode_fields_maybe_capturing(
+      context,
+      _fields,
+      _unknown_fields.get(),
+      value,
+      [&](const std::string &key) { return _fields.find(key); },
+      [&](const std::string &, const detail::field &field) { field.decode(context, value); });
+}
+
+void object_t_base::decode_after_first_member(decode_context &context, void *value) const {
+  decode_fields_maybe_capturing(
+      context,
+      _fields,
+      _unknown_fields.get(),
+      value,
+      [&](const std::string &key) { return _fields.find(key); },
+      [&](const std::string &, const detail::field &field) { field.decode(context, value); },
+      true);
+}
+
+void object_t_base::decode(
+    decode_context &context,
+    void *value,
+    const field_projection &projection) const {
+  check_projection(projection);
+  decode_fields_maybe_profiled<string_t>(
+      context,
+      _fields,
+      projection.num_required_fields(),
+      [&](const std::string &key) -> const detail::field * {
+        const auto index = _fields.find_index(key);
+        return (index != json_size_t_max && projection.is_selected(index)) ? &_fields.at(index) : nullptr;
+      },
+      [&](const std::string &, const detail::field &field) { field.decode(context, value); },
+      skip_unknown_field(context));
+}
+
+void object_t_base::decode_into(decode_context &context, void *value, const void *prototype) const {
+  // Only codecs with more than 256 fields allocate to track the seen fields
+  detail::bitset<256> seen(_fields.size());
+  decode_fields_maybe_capturing(
+      context,
+      _fields,
+      _unknown_fields.get(),
+      value,
+      [&](const std::string &key) -> const detail::field * {
+        const auto index = _fields.find_index(key);
+        if (json_unlikely(index == json_size_t_max)) {
+          return nullptr;
+        }
+        seen.test_and_set(index);
+        return &_fields.at(index);
+      },
+      [&](const std::string &, const detail::field &field) { field.decode_into(context, value); });
+
+  const auto num_fields = _fields.size();
+  auto it = _fields.begin();
+  for (size_t i = 0; i < num_fields; i++, ++it) {
+    if (!seen.test(i)) {
+      it->second->reset(value, prototype);
+    }
+  }
+}
+
 void object_t_base::encode(encode_context &context, const void *value) const {
+  const auto profile = detail::field_profiling_enabled();
   context.append('{');
   for (const auto &kv : _fields) {
     const auto &field = *kv.second.get();
-    field.encode(context, kv.first, value);
+    if (json_unlikely(profile)) {
+      encode_field_profiled(context, kv.first, field, value);
+    } else {
+      field.encode(context, kv.first, value);
+    }
+  }
+  if (json_unlikely(_unknown_fields)) {
+    for (const auto &unknown : _unknown_fields->get(value)) {
+      context.append(unknown.key.data(), unknown.key.size());
+      context.append(':');
+      context.append(unknown.value.data(), unknown.value.size());
+      context.append(',');
+    }
+  }
+  context.append_or_replace(',', '}');
+}
+
+void object_t_base::encode(
+    encode_context &context,
+    const void *value,
+    const field_projection &projection) const {
+  check_projection(projection);
+  const auto profile = detail::field_profiling_enabled();
+  context.append('{');
+  const auto num_fields = _fields.size();
+  auto it = _fields.begin();
+  for (size_t i = 0; i < num_fields; i++, ++it) {
+    if (projection.is_selected(i)) {
+      if (json_unlikely(profile)) {
+        encode_field_profiled(context, it->first, *it->second, value);
+      } else {
+        it->second->encode(context, it->first, value);
+      }
+    }
   }
   context.append_or_replace(',', '}');
 }
 
+namespace {
+
+const void *first_field(const detail::field_registry &fields) {
+  return fields.size() ? &fields.at(0) : nullptr;
+}
+
+}  // namespace
+
+field_projection object_t_base::make_projection(const std::vector<std::string> &names) const {
+  field_projection projection(_fields.size(), first_field(_fields));
+  for (const auto &name : names) {
+    const auto index = _fields.find_index(name);
+    if (index == json_size_t_max) {
+      throw std::invalid_argument("Unknown field in projection: " + name);
+    }
+    if (!projection._selected[index]) {
+      projection._selected[index] = true;
+      projection._num_required_fields += _fields.at(index).is_required() ? 1 : 0;
+    }
+  }
+  return projection;
+}
+
+void object_t_base::check_projection(const field_projection &projection) const {
+  if (json_unlikely(
+      projection._selected.size() != _fields.size() ||
+      projection._first_field != first_field(_fields))) {
+    throw std::invalid_argument("The field_projection was not created by this codec");
+  }
+}
+
 }  // namespace codec_detail
 }  // namespace codec
 }  // namespace json
@@ -15,12 +15,17 @@
  */
 
 #include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/shared_string.hpp>
+
+#include <array>
+#include <cstring>
 
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/escape.hpp>
 #include <spotify/json/detail/macros.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/slow_path_counters.hpp>
 
 namespace spotify {
 namespace json {
@@ -39,52 +44,80 @@ uint32_t codepoint_from_surrogate_pair(uint32_t high, uint32_t low) {
   return (((high & 0x03FF) << 10) | (low & 0x03FF)) + 0x10000;
 }
 
-uint8_t decode_hex_nibble(decode_context &context, const char c) {
-  if (c >= '0' && c <= '9') { return c - '0'; }
-  if (c >= 'a' && c <= 'f') { return c - 'a' + 0xA; }
-  if (c >= 'A' && c <= 'F') { return c - 'A' + 0xA; }
+/**
+ * Maps each byte to its value as a hex digit. Bytes that are not hex digits
+ * map to a value with the upper 16 bits set, which survive the shifts in
+ * decode_hex_number, so that four digits can be decoded without branching and
+ * checked once at the end.
+ */
+constexpr std::array<uint32_t, 256> make_hex_values() {
+  std::array<uint32_t, 256> values{};
+  for (unsigned c = 0; c < 256; c++) {
+    values[c] = 0xFFFF0000;
+  }
+  for (unsigned c = '0'; c <= '9'; c++) {
+    values[c] = c - '0';
+  }
+  for (unsigned c = 'a'; c <= 'f'; c++) {
+    values[c] = c - 'a' + 0xA;
+    values[c - 'a' + 'A'] = c - 'a' + 0xA;
+  }
+  return values;
+}
+
+constexpr std::array<uint32_t, 256> HEX_VALUES = make_hex_values();
+
+json_noreturn json_never_inline void fail_hex_number(decode_context &context, const uint8_t *digits) {
+  // Report the error after the first invalid digit
+  auto i = 0;
+  while (HEX_VALUES[digits[i]] <= 0xF) {
+    i++;
+  }
+  context.position += i + 1;
   detail::fail(context, "\\u must be followed by 4 hex digits");
 }
 
 unsigned decode_hex_number(decode_context &context) {
   detail::require_bytes<4>(context, "\\u must be followed by 4 hex digits");
-  const auto a = decode_hex_nibble(context, *(context.position++));
-  const auto b = decode_hex_nibble(context, *(context.position++));
-  const auto c = decode_hex_nibble(context, *(context.position++));
-  const auto d = decode_hex_nibble(context, *(context.position++));
-  return unsigned((a << 12) | (b << 8) | (c << 4) | d);
+  const auto digits = reinterpret_cast<const uint8_t *>(context.position);
+  const auto n =
+      (HEX_VALUES[digits[0]] << 12) |
+      (HEX_VALUES[digits[1]] <<  8) |
+      (HEX_VALUES[digits[2]] <<  4) |
+      (HEX_VALUES[digits[3]] <<  0);
+  if (json_unlikely(n > 0xFFFF)) {
+    fail_hex_number(context, digits);
+  }
+  context.position += 4;
+  return unsigned(n);
 }
 
-void encode_utf8_4(std::string &out, uint32_t p) {
-  const char c0 = 0xF0 | ((p >> 18) & 0x07);
-  const char c1 = 0x80 | ((p >> 12) & 0x3F);
-  const char c2 = 0x80 | ((p >>  6) & 0x3F);
-  const char c3 = 0x80 | ((p >>  0) & 0x3F);
-  const char cc[] = { c0, c1, c2, c3 };
-  out.append(&cc[0], 4);
+void encode_utf8_4(char *&out, uint32_t p) {
+  out[0] = char(0xF0 | ((p >> 18) & 0x07));
+  out[1] = char(0x80 | ((p >> 12) & 0x3F));
+  out[2] = char(0x80 | ((p >>  6) & 0x3F));
+  out[3] = char(0x80 | ((p >>  0) & 0x3F));
+  out += 4;
 }
 
-void encode_utf8_3(std::string &out, unsigned p) {
-  const char c0 = 0xE0 | ((p >> 12) & 0x0F);
-  const char c1 = 0x80 | ((p >>  6) & 0x3F);
-  const char c2 = 0x80 | ((p >>  0) & 0x3F);
-  const char cc[] = { c0, c1, c2 };
-  out.append(&cc[0], 3);
+void encode_utf8_3(char *&out, unsigned p) {
+  out[0] = char(0xE0 | ((p >> 12) & 0x0F));
+  out[1] = char(0x80 | ((p >>  6) & 0x3F));
+  out[2] = char(0x80 | ((p >>  0) & 0x3F));
+  out += 3;
 }
 
-void encode_utf8_2(std::string &out, unsigned p) {
-  const char c0 = 0xC0 | ((p >> 6) & 0x1F);
-  const char c1 = 0x80 | ((p >> 0) & 0x3F);
-  const char cc[] = { c0, c1 };
-  out.append(&cc[0], 2);
+void encode_utf8_2(char *&out, unsigned p) {
+  out[0] = char(0xC0 | ((p >> 6) & 0x1F));
+  out[1] = char(0x80 | ((p >> 0) & 0x3F));
+  out += 2;
 }
 
-void encode_utf8_1(std::string &out, unsigned p) {
-  const char c0 = (p & 0x7F);
-  out.push_back(c0);
+void encode_utf8_1(char *&out, unsigned p) {
+  *(out++) = char(p & 0x7F);
 }
 
-void encode_utf8(std::string &out, unsigned p) {
+void encode_utf8(char *&out, unsigned p) {
   if (json_likely(p <= 0x7F)) {
     encode_utf8_1(out, p);
   } else if (json_likely(p <= 0x07FF)) {
@@ -94,7 +127,7 @@ void encode_utf8(std::string &out, unsigned p) {
   }
 }
 
-bool handle_surrogate_pair(decode_context &context, std::string &out, unsigned p) {
+bool handle_surrogate_pair(decode_context &context, char *&out, unsigned p) {
   if (json_unlikely(is_high_surrogate(p))) {
     // Parse low surrogate
     if (detail::peek_2(context, '\\', 'u')) {
@@ -114,41 +147,85 @@ bool handle_surrogate_pair(decode_context &context, std::string &out, unsigned p
   return false;
 }
 
-void decode_unicode_escape(decode_context &context, std::string &out) {
+void decode_unicode_escape(decode_context &context, char *&out) {
   const auto p = decode_hex_number(context);
   if (json_likely(!handle_surrogate_pair(context, out, p))) {
     encode_utf8(out, p);
   }
 }
 
-void decode_escape(decode_context &context, std::string &out) {
+void decode_escape(decode_context &context, char *&out) {
   const auto escape_character = detail::next(context, "Unterminated string");
   switch (escape_character) {
-    case '"':  out.push_back('"');  break;
-    case '/':  out.push_back('/');  break;
-    case 'b':  out.push_back('\b'); break;
-    case 'f':  out.push_back('\f'); break;
-    case 'n':  out.push_back('\n'); break;
-    case 'r':  out.push_back('\r'); break;
-    case 't':  out.push_back('\t'); break;
-    case '\\': out.push_back('\\'); break;
+    case '"':  *(out++) = '"';  break;
+    case '/':  *(out++) = '/';  break;
+    case 'b':  *(out++) = '\b'; break;
+    case 'f':  *(out++) = '\f'; break;
+    case 'n':  *(out++) = '\n'; break;
+    case 'r':  *(out++) = '\r'; break;
+    case 't':  *(out++) = '\t'; break;
+    case '\\': *(out++) = '\\'; break;
     case 'u': decode_unicode_escape(context, out); break;
     default: detail::fail(context, "Invalid escape character", -1);
   }
 }
 
-string_t::object_type decode_escaped_string(decode_context &context, const char *begin) {
-  std::string unescaped(begin, context.position - 1);
-  decode_escape(context, unescaped);
+/**
+ * Find the closing quote of the string whose characters start at begin,
+ * searching from position. A quote closes the string if it is preceded by an
+ * even number of backslashes. If the string is not terminated, the end of the
+ * input is returned and the error is left for the decoding to report.
+ */
+const char *find_string_end(const char *begin, const char *position, const char *end) {
+  while (position != end) {
+    const auto quote = static_cast<const char *>(std::memchr(position, '"', size_t(end - position)));
+    if (!quote) {
+      break;
+    }
 
-  while (json_likely(context.remaining())) {
-    const auto begin_simple = context.position;
+    auto backslashes = quote;
+    while (backslashes != begin && *(backslashes - 1) == '\\') {
+      --backslashes;
+    }
+    if ((quote - backslashes) % 2 == 0) {
+      return quote;
+    }
+    position = quote + 1;
+  }
+  return end;
+}
+
+json_force_inline void copy_simple_characters(decode_context &context, char *&out) {
+  if (json_unlikely(context.validate_utf8)) {
+    const auto begin = context.position;
     detail::skip_any_simple_characters(context);
-    unescaped.append(begin_simple, context.position);
+    const auto length = size_t(context.position - begin);
+    std::memcpy(out, begin, length);
+    out += length;
+  } else {
+    detail::copy_any_simple_characters(context, out);
+  }
+}
+
+void decode_escaped_string(decode_context &context, const char *begin, std::string &out) {
+  json_count_slow_path(decode_escaped_string);
+
+  // Unescaping never makes a string longer, so the output is sized once from
+  // the span of the escaped input and written to directly. The extra 16 bytes
+  // are room for copy_any_simple_characters to store whole chunks.
+  const auto escape = context.position - 1;
+  out.resize(size_t(find_string_end(begin, context.position, context.end) - begin) + 16);
+  auto dst = &out[0];
+  std::memcpy(dst, begin, size_t(escape - begin));
+  dst += escape - begin;
+  decode_escape(context, dst);
+
+  while (json_likely(context.remaining())) {
+    copy_simple_characters(context, dst);
 
     switch (detail::next(context, "Unterminated string")) {
-      case '"': return unescaped;
-      case '\\': decode_escape(context, unescaped); break;
+      case '"': out.resize(size_t(dst - out.data())); return;
+      case '\\': decode_escape(context, dst); break;
       default: json_unreachable();
     }
   }
@@ -156,25 +233,18 @@ string_t::object_type decode_escaped_string(decode_context &context, const char
   detail::fail(context, "Unterminated string");
 }
 
-string_t::object_type decode_string(decode_context &context) {
+void decode_string(decode_context &context, std::string &out) {
   const auto begin_simple = context.position;
   detail::skip_any_simple_characters(context);
 
   switch (detail::next(context, "Unterminated string")) {
-    case '"': return std::string(begin_simple, context.position - 1);
-    case '\\': return decode_escaped_string(context, begin_simple);
+    case '"': out.assign(begin_simple, context.position - 1); return;
+    case '\\': return decode_escaped_string(context, begin_simple, out);
     default: json_unreachable();
   }
 }
 
-}  // namespace
-
-string_t::object_type string_t::decode(decode_context &context) const {
-  detail::skip_1(context, '"');
-  return decode_string(context);
-}
-
-void string_t::encode(encode_context &context, const object_type value) const {
+void encode_string(encode_context &context, const char *data, size_t size) {
   context.append('"');
 
   // Write the strings in 1024 byte chunks, so that we do not have to reserve a
@@ -183,11 +253,19 @@ void string_t::encode(encode_context &context, const object_type value) const {
   // that is ok since write_escaped will not escape characters with the high bit
   // set, so the combined escaped string contains the correct UTF-8 characters
   // in the end.
-  auto chunk_begin = value.data();
-  const auto string_end = chunk_begin + value.size();
+  auto chunk_begin = data;
+  const auto string_end = data + size;
 
   while (chunk_begin != string_end) {
-    const auto chunk_end = std::min(chunk_begin + 1024, string_end);
+    auto chunk_end = std::min(chunk_begin + 1024, string_end);
+    if (json_unlikely(context.validate_utf8)) {
+      // Each chunk is validated on its own, so chunks must not split a UTF-8
+      // sequence. Sequences are at most four bytes long; if there are more
+      // continuation bytes in a row, the string is invalid either way.
+      for (int i = 0; i < 3 && chunk_end != string_end && (uint8_t(*chunk_end) & 0xC0) == 0x80; i++) {
+        chunk_end--;
+      }
+    }
     detail::write_escaped(context, chunk_begin, chunk_end);
     chunk_begin = chunk_end;
   }
@@ -195,6 +273,54 @@ void string_t::encode(encode_context &context, const object_type value) const {
   context.append('"');
 }
 
+shared_string make_owned_string(const std::shared_ptr<std::string> &string) {
+  return shared_string(string, string->data(), string->size());
+}
+
+}  // namespace
+
+string_t::object_type string_t::decode(decode_context &context) const {
+  object_type value;
+  decode_into(context, value);
+  return value;
+}
+
+void string_t::decode_into(decode_context &context, object_type &value) const {
+  detail::skip_1(context, '"');
+  decode_string(context, value);
+}
+
+void string_t::encode(encode_context &context, const object_type &value) const {
+  encode_string(context, value.data(), value.size());
+}
+
+shared_string_t::object_type shared_string_t::decode(decode_context &context) const {
+  detail::skip_1(context, '"');
+
+  if (json_unlikely(!context.input_owner)) {
+    auto owned = std::make_shared<std::string>();
+    decode_string(context, *owned);
+    return make_owned_string(owned);
+  }
+
+  const auto begin = context.position;
+  detail::skip_any_simple_characters(context);
+
+  switch (detail::next(context, "Unterminated string")) {
+    case '"': return shared_string(*context.input_owner, begin, size_t(context.position - 1 - begin));
+    case '\\': {
+      auto owned = std::make_shared<std::string>();
+      decode_escaped_string(context, begin, *owned);
+      return make_owned_string(owned);
+    }
+    default: json_unreachable();
+  }
+}
+
+void shared_string_t::encode(encode_context &context, const object_type &value) const {
+  encode_string(context, value.data(), value.size());
+}
+
 }  // namespace codec
 }  // namespace json
 }  // namespace spotify
@@ -31,5 +31,12 @@ decode_context::decode_context(const char *data, size_t size)
       begin(data),
       end(data + size) {}
 
+decode_context::decode_context(const padded_string_view &input)
+    : has_sse42(detail::cpuid().has_sse42()),
+      padded(true),
+      position(input.data()),
+      begin(input.data()),
+      end(input.data() + input.size()) {}
+
 }  // namespace json
 }  // namespace spotify
@@ -16,6 +16,8 @@
 
 #include <spotify/json/detail/bitset.hpp>
 
+#include <spotify/json/slow_path_counters.hpp>
+
 namespace spotify {
 namespace json {
 namespace detail {
@@ -26,6 +28,7 @@ bitset_base::bitset_base(const std::size_t size, uint8_t *inline_base) {
   if (inline_base) {
     _base = inline_base;
   } else {
+    json_count_slow_path(bitset_spill);
     _vector.reset(new std::vector<uint8_t>((size + 7) / 8));
     _base = _vector->data();
   }
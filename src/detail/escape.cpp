@@ -17,9 +17,12 @@
 #include <spotify/json/detail/escape.hpp>
 
 #include <cstring>
+#include <spotify/json/detail/encode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
+#include <spotify/json/slow_path_counters.hpp>
 
 #include "escape_common.hpp"
+#include "utf8_common.hpp"
 
 namespace spotify {
 namespace json {
@@ -27,6 +30,7 @@ namespace detail {
 
 #if defined(json_arch_x86_sse42)
 void write_escaped_sse42(encode_context &context, const char *begin, const char *end);
+void write_escaped_utf8_sse42(encode_context &context, const char *begin, const char *end);
 #endif  // defined(json_arch_x86_sse42)
 
 void write_escaped_scalar(encode_context &context, const char *begin, const char *end) {
@@ -44,12 +48,42 @@ void write_escaped_scalar(encode_context &context, const char *begin, const char
   context.advance(ptr - buf);
 }
 
+void write_escaped_utf8_scalar(encode_context &context, const char *begin, const char *end) {
+  const auto buf = context.reserve(6 * (end - begin));  // 6 is the length of \u00xx
+  auto ptr = buf;
+
+  while (begin < end) {
+    if (json_likely(uint8_t(*begin) < 0x80)) {
+      write_escaped_c(ptr, *(begin++));
+    } else {
+      const auto length = utf8_sequence_length(begin, end);
+      fail_if(context, length == 0, "Invalid UTF-8");
+      memcpy(ptr, begin, length);
+      ptr += length;
+      begin += length;
+    }
+  }
+
+  context.advance(ptr - buf);
+}
+
 void write_escaped(encode_context &context, const char *begin, const char *end) {
+  if (json_unlikely(context.validate_utf8)) {
+#if defined(json_arch_x86_sse42)
+    if (json_likely(context.has_sse42)) {
+      return write_escaped_utf8_sse42(context, begin, end);
+    }
+#endif  // defined(json_arch_x86_sse42)
+    json_count_slow_path(scalar_fallback);
+    return write_escaped_utf8_scalar(context, begin, end);
+  }
+
 #if defined(json_arch_x86_sse42)
   if (json_likely(context.has_sse42)) {
     return write_escaped_sse42(context, begin, end);
   }
 #endif  // defined(json_arch_x86_sse42)
+  json_count_slow_path(scalar_fallback);
   write_escaped_scalar(context, begin, end);
 }
 
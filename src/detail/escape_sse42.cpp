@@ -20,45 +20,61 @@
 
 #include <nmmintrin.h>
 
+#include <spotify/json/detail/encode_helpers.hpp>
+
 #include "escape_common.hpp"
+#include "utf8_sse42.hpp"
 
 namespace spotify {
 namespace json {
 namespace detail {
 
-json_force_inline void write_escaped_16_sse42(char *&out, const __m128i chunk) {
-  write_escaped_c(out, _mm_extract_epi8(chunk, 0));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 1));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 2));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 3));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 4));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 5));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 6));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 7));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 8));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 9));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 10));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 11));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 12));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 13));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 14));
-  write_escaped_c(out, _mm_extract_epi8(chunk, 15));
+/**
+ * Return a mask with one bit set for each byte of the chunk that needs to be
+ * escaped: control characters, quotation marks and backslashes.
+ */
+json_force_inline unsigned escape_mask_sse42(const __m128i chunk) {
+  const auto is_control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk);
+  const auto is_quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+  const auto is_backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+  return unsigned(_mm_movemask_epi8(_mm_or_si128(is_control, _mm_or_si128(is_quote, is_backslash))));
+}
+
+/**
+ * Write a chunk that has at least one byte to escape. The simple bytes in
+ * between the escaped ones are copied 16 at a time from a copy of the chunk
+ * that is padded so that the copies never read outside of it. Each store can
+ * write up to 16 bytes past what the chunk needs, so the callers reserve 16
+ * bytes more than the longest possible output.
+ */
+json_force_inline void write_escaped_16_sse42(char *&out, const __m128i chunk, unsigned mask) {
+  alignas(16) char padded[32];
+  _mm_store_si128(reinterpret_cast<__m128i *>(&padded[0]), chunk);
+  _mm_store_si128(reinterpret_cast<__m128i *>(&padded[16]), _mm_setzero_si128());
+
+  unsigned written = 0;
+  do {
+    const auto index = count_trailing_zeros(mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_loadu_si128(reinterpret_cast<const __m128i *>(&padded[written])));
+    out += index - written;
+    write_escaped_c(out, padded[index]);
+    written = index + 1;
+    mask &= mask - 1;
+  } while (mask);
+
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_loadu_si128(reinterpret_cast<const __m128i *>(&padded[written])));
+  out += 16 - written;
 }
 
 void write_escaped_sse42(
     encode_context &context,
     const char *begin,
     const char *end) {
-  const auto buf = context.reserve(6 * (end - begin));  // 6 is the length of \u00xx
+  // 6 is the length of \u00xx, and the extra 16 bytes are for the stores of
+  // write_escaped_16_sse42
+  const auto buf = context.reserve(6 * (end - begin) + 16);
   auto out = buf;
 
-  const __m128i ranges = _mm_setr_epi8(
-    0x00, 0x1F,  // null byte & control characters
-    0x22, 0x22,  // double quotation mark
-    0x5C, 0x5C,  // reverse solidus (backslash)
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0
-  );
-
   if (json_unaligned_2(begin) && (end - begin) >= 1) { write_escaped_1(out, begin); }
   if (json_unaligned_4(begin) && (end - begin) >= 2) { write_escaped_2(out, begin); }
   if (json_unaligned_8(begin) && (end - begin) >= 4) { write_escaped_4(out, begin); }
@@ -66,12 +82,12 @@ void write_escaped_sse42(
 
   for (; end - begin >= 16; begin += 16) {
     const __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(begin));
-    const unsigned has_character_in_ranges = _mm_cmpestrc(ranges, 6, chunk, 16, _SIDD_CMP_RANGES);
-    if (json_likely(!has_character_in_ranges)) {
+    const auto mask = escape_mask_sse42(chunk);
+    if (json_likely(!mask)) {
       _mm_storeu_si128(reinterpret_cast<__m128i *>(out), chunk);
       out += 16;
     } else {
-      write_escaped_16_sse42(out, chunk);
+      write_escaped_16_sse42(out, chunk, mask);
     }
   }
 
@@ -83,6 +99,43 @@ void write_escaped_sse42(
   context.advance(out - buf);
 }
 
+void write_escaped_utf8_sse42(
+    encode_context &context,
+    const char *begin,
+    const char *end) {
+  // 6 is the length of \u00xx, and the extra 16 bytes are for the stores of
+  // write_escaped_16_sse42
+  const auto buf = context.reserve(6 * (end - begin) + 16);
+  auto out = buf;
+  utf8_checker_sse42 checker;
+
+  // Unlike write_escaped_sse42, this does not align the reads, since all
+  // bytes must be given to the UTF-8 checker in order and in whole chunks.
+  for (; end - begin >= 16; begin += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+    checker.check(chunk);
+    const auto mask = escape_mask_sse42(chunk);
+    if (json_likely(!mask)) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), chunk);
+      out += 16;
+    } else {
+      write_escaped_16_sse42(out, chunk, mask);
+    }
+  }
+
+  // The remaining bytes are padded with zeros, which also reports a sequence
+  // that is cut short by the end of the string.
+  checker.check(load_partial_16(begin, end - begin));
+  fail_if(context, checker.has_error(), "Invalid UTF-8");
+
+  if ((end - begin) >= 8) { write_escaped_8(out, begin); }
+  if ((end - begin) >= 4) { write_escaped_4(out, begin); }
+  if ((end - begin) >= 2) { write_escaped_2(out, begin); }
+  if ((end - begin) >= 1) { write_escaped_1(out, begin); }
+
+  context.advance(out - buf);
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
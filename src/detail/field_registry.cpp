@@ -25,7 +25,9 @@ namespace detail {
 namespace {
 
 std::string escape_key(const std::string &key) {
-  encode_context context;
+  // Sized for the worst case, where every character is escaped as \u00XX,
+  // instead of the default 4 KB of an encode_context.
+  encode_context context(key.size() * 6 + 3);
   codec::string().encode(context, key);
   context.append(':');
   return std::string(context.data(), context.size());
@@ -41,7 +43,7 @@ field_registry::field_registry(field_registry &&) = default;
 void field_registry::save(const std::string &name, bool required,
                           const std::shared_ptr<field> &f) {
   const auto was_saved =
-      _fields.insert(typename field_map::value_type(name, f)).second;
+      _fields.insert(typename field_map::value_type(name, _field_list.size())).second;
   if (was_saved) {
     _field_list.push_back(std::make_pair(escape_key(name), f));
     _num_required_fields += required ? 1 : 0;
@@ -51,12 +53,17 @@ void field_registry::save(const std::string &name, bool required,
 const field *field_registry::find(const std::string &name) const noexcept {
   const auto field_it = _fields.find(name);
   if (json_likely(field_it != _fields.end())) {
-    return (*field_it).second.get();
+    return _field_list[(*field_it).second].second.get();
   } else {
     return nullptr;
   }
 }
 
+size_t field_registry::find_index(const std::string &name) const noexcept {
+  const auto field_it = _fields.find(name);
+  return (field_it != _fields.end()) ? (*field_it).second : json_size_t_max;
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -16,9 +16,13 @@
 
 #include <spotify/json/detail/skip_chars.hpp>
 
+#include <cstring>
+
+#include <spotify/json/detail/decode_helpers.hpp>
 #include <spotify/json/detail/macros.hpp>
 
 #include "skip_chars_common.hpp"
+#include "utf8_common.hpp"
 
 namespace spotify {
 namespace json {
@@ -37,6 +41,30 @@ void skip_any_simple_characters_scalar(decode_context &context) {
   done_x: context.position = pos;
 }
 
+void skip_any_simple_characters_utf8_scalar(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+  while (pos < end && *pos != '"' && *pos != '\\') {
+    if (json_likely(uint8_t(*pos) < 0x80)) {
+      ++pos;
+    } else {
+      const auto length = utf8_sequence_length(pos, end);
+      context.position = pos;
+      fail_if(context, length == 0, "Invalid UTF-8");
+      pos += length;
+    }
+  }
+  context.position = pos;
+}
+
+void copy_any_simple_characters_scalar(decode_context &context, char *&out) {
+  const auto begin = context.position;
+  skip_any_simple_characters_scalar(context);
+  const auto length = size_t(context.position - begin);
+  std::memcpy(out, begin, length);
+  out += length;
+}
+
 void skip_any_whitespace_scalar(decode_context &context) {
   const auto end = context.end;
   auto pos = context.position;
@@ -18,9 +18,14 @@
 
 #if defined(json_arch_x86_sse42)
 
+#include <algorithm>
+
 #include <nmmintrin.h>
 
+#include <spotify/json/detail/decode_helpers.hpp>
+
 #include "skip_chars_common.hpp"
+#include "utf8_sse42.hpp"
 
 namespace spotify {
 namespace json {
@@ -57,6 +62,75 @@ void skip_any_simple_characters_sse42(decode_context &context) {
   done_x: context.position = pos;
 }
 
+void skip_any_simple_characters_utf8_sse42(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+  alignas(16) static const char CHARS[16] = "\"\\";
+  const auto chars = _mm_load_si128(reinterpret_cast<const __m128i *>(&CHARS[0]));
+  utf8_checker_sse42 checker;
+
+  for (;;) {
+    const auto remaining = size_t(end - pos);
+    const auto available = std::min(remaining, size_t(16));
+    const auto chunk = (available == 16 || context.padded ?
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos)) :
+        load_partial_16(pos, available));
+
+    constexpr auto flags = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_POSITIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT;
+    const auto index = size_t(_mm_cmpestri(chars, 2, chunk, 16, flags));
+    const auto simple_length = std::min(available, index);
+
+    // The bytes after the simple characters are zeroed, both so that they are
+    // not validated and so that a sequence that is cut short is reported.
+    if (simple_length < 16) {
+      checker.check(keep_first_n(chunk, simple_length));
+      pos += simple_length;
+      break;
+    }
+
+    checker.check(chunk);
+    pos += 16;
+    if (pos == end) {
+      checker.check_eof();
+      break;
+    }
+  }
+
+  fail_if(context, checker.has_error(), "Invalid UTF-8");
+  context.position = pos;
+}
+
+void copy_any_simple_characters_sse42(decode_context &context, char *&out) {
+  const auto end = context.end;
+  auto pos = context.position;
+  auto dst = out;
+  const auto quote = _mm_set1_epi8('"');
+  const auto backslash = _mm_set1_epi8('\\');
+
+  // Each chunk is stored in full before looking at where the run ends, which
+  // may write up to 16 bytes past the copied run; the caller leaves room.
+  for (; end - pos >= 16; pos += 16, dst += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), chunk);
+    const auto mask = unsigned(_mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(chunk, quote),
+        _mm_cmpeq_epi8(chunk, backslash))));
+    if (mask) {
+      const auto index = count_trailing_zeros(mask);
+      context.position = pos + index;
+      out = dst + index;
+      return;
+    }
+  }
+
+  while (pos < end && *pos != '"' && *pos != '\\') {
+    *(dst++) = *(pos++);
+  }
+
+  context.position = pos;
+  out = dst;
+}
+
 void skip_any_whitespace_sse42(decode_context &context) {
   const auto end = context.end;
   auto pos = context.position;
@@ -88,6 +162,77 @@ void skip_any_whitespace_sse42(decode_context &context) {
   context.position = pos;
 }
 
+/*
+ * The padded kernels below may read up to 16 bytes past context.end, which is
+ * allowed when context.padded is set. They load unaligned chunks all the way
+ * to the end and clamp the result to it, so they need neither an alignment
+ * prologue nor a scalar tail.
+ */
+
+void skip_any_simple_characters_padded_sse42(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+  const auto quote = _mm_set1_epi8('"');
+  const auto backslash = _mm_set1_epi8('\\');
+
+  for (;; pos += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    const auto mask = unsigned(_mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(chunk, quote),
+        _mm_cmpeq_epi8(chunk, backslash))));
+    const auto remaining = size_t(end - pos);
+    if (mask || remaining <= 16) {
+      context.position = pos + std::min(size_t(mask ? count_trailing_zeros(mask) : 16), remaining);
+      return;
+    }
+  }
+}
+
+void copy_any_simple_characters_padded_sse42(decode_context &context, char *&out) {
+  const auto end = context.end;
+  auto pos = context.position;
+  auto dst = out;
+  const auto quote = _mm_set1_epi8('"');
+  const auto backslash = _mm_set1_epi8('\\');
+
+  for (;; pos += 16, dst += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), chunk);
+    const auto mask = unsigned(_mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(chunk, quote),
+        _mm_cmpeq_epi8(chunk, backslash))));
+    const auto remaining = size_t(end - pos);
+    if (mask || remaining <= 16) {
+      const auto index = std::min(size_t(mask ? count_trailing_zeros(mask) : 16), remaining);
+      context.position = pos + index;
+      out = dst + index;
+      return;
+    }
+  }
+}
+
+void skip_any_whitespace_padded_sse42(decode_context &context) {
+  const auto end = context.end;
+  auto pos = context.position;
+  const auto space = _mm_set1_epi8(' ');
+  const auto tab = _mm_set1_epi8('\t');
+  const auto newline = _mm_set1_epi8('\n');
+  const auto carriage_return = _mm_set1_epi8('\r');
+
+  for (;; pos += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    const auto spaces = unsigned(_mm_movemask_epi8(_mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriage_return)))));
+    const auto mask = ~spaces & 0xFFFF;
+    const auto remaining = size_t(end - pos);
+    if (mask || remaining <= 16) {
+      context.position = pos + std::min(size_t(mask ? count_trailing_zeros(mask) : 16), remaining);
+      return;
+    }
+  }
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
@@ -210,6 +210,67 @@ void skip_value(decode_context &context) {
   fail_if(context, pstate != done, "Unexpected EOF");
 }
 
+namespace {
+
+size_t count_comma_separated(const decode_context &context, const char intro, const char outro) {
+  // This is a structural scan that only keeps track of strings and nesting,
+  // without validating the values. Invalid JSON gives a count that may be off,
+  // which is harmless since it is only used as a hint; the error is reported
+  // when the array or object is decoded.
+  auto scan = context;
+  if (peek(scan) != intro) {
+    return 0;
+  }
+  skip_unchecked_1(scan);
+  skip_any_whitespace(scan);
+  if (peek(scan) == outro) {
+    return 0;
+  }
+
+  size_t count = 1;
+  size_t depth = 1;
+  while (json_likely(scan.remaining())) {
+    switch (*(scan.position++)) {
+      case '"':
+        for (;;) {
+          skip_any_simple_characters(scan);
+          if (json_unlikely(!scan.remaining())) {
+            return 0;
+          }
+          if (*(scan.position++) == '"') {
+            break;
+          }
+          if (json_likely(scan.remaining())) {
+            scan.position++;  // skip the escaped character
+          }
+        }
+        break;
+      case '[': case '{': depth++; break;
+      case ']': case '}':
+        if (--depth == 0) {
+          return count;
+        }
+        break;
+      case ',':
+        count += (depth == 1);
+        break;
+      default: break;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+size_t count_array_elements(const decode_context &context) {
+  return count_comma_separated(context, '[', ']');
+}
+
+size_t count_object_members(const decode_context &context) {
+  return count_comma_separated(context, '{', '}');
+}
+
 }  // namespace detail
 }  // namespace json
 }  // namespace spotify
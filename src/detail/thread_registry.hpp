@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Add to a counter that only the calling thread writes to. A relaxed load and
+ * store is enough for that, and is cheaper than an atomic read-modify-write;
+ * the counter is an atomic only so that other threads can read it.
+ */
+json_force_inline void increment(std::atomic<uint64_t> &counter, const uint64_t amount) {
+  counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * Keeps a thread_type for each thread that calls local(), which that thread
+ * can write to without taking a lock, and a registry of them that any thread
+ * can sum into a sum_type. The add function adds one thread_type to a sum. It
+ * is also used to keep the sum of the threads that have exited, when their
+ * thread_type is destroyed.
+ *
+ * There is one registry per thread_type. It is never destroyed, since threads
+ * may exit after static destructors have run.
+ */
+template <typename thread_type, typename sum_type, void (*add)(sum_type &, const thread_type &)>
+class thread_registry final {
+ public:
+  static thread_type &local() {
+    static thread_local registered_thread thread;
+    return thread.value;
+  }
+
+  static sum_type sum() {
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto sum = r.exited;
+    for (const auto thread : r.threads) {
+      add(sum, *thread);
+    }
+    return sum;
+  }
+
+  /**
+   * Forget the threads that have exited and call reset_thread with the
+   * thread_type of each of the running threads.
+   */
+  template <typename reset_function>
+  static void reset(reset_function reset_thread) {
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.exited = sum_type();
+    for (const auto thread : r.threads) {
+      reset_thread(*thread);
+    }
+  }
+
+ private:
+  struct registry_type {
+    std::mutex mutex;
+    std::vector<thread_type *> threads;
+    sum_type exited;
+  };
+
+  static registry_type &registry() {
+    static auto *instance = new registry_type();
+    return *instance;
+  }
+
+  struct registered_thread {
+    registered_thread() {
+      auto &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.threads.push_back(&value);
+    }
+
+    ~registered_thread() {
+      auto &r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      add(r.exited, value);
+      r.threads.erase(std::find(r.threads.begin(), r.threads.end(), &value));
+    }
+
+    thread_type value{};
+  };
+};
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <spotify/json/detail/macros.hpp>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+json_force_inline bool is_utf8_continuation(const uint8_t c, const uint8_t min = 0x80, const uint8_t max = 0xBF) {
+  return (c >= min && c <= max);
+}
+
+/**
+ * Return the length of the well-formed UTF-8 sequence that starts with the
+ * non-ASCII byte at pos, or 0 if there is no such sequence. This follows
+ * table 3-7 of the Unicode standard, so overlong encodings, surrogates and
+ * code points above U+10FFFF are rejected.
+ */
+json_force_inline size_t utf8_sequence_length(const char *pos, const char *end) {
+  const auto remaining = end - pos;
+  const auto b0 = uint8_t(pos[0]);
+  const auto b1 = uint8_t(remaining >= 2 ? pos[1] : 0);
+  const auto b2 = uint8_t(remaining >= 3 ? pos[2] : 0);
+  const auto b3 = uint8_t(remaining >= 4 ? pos[3] : 0);
+
+  if (b0 >= 0xC2 && b0 <= 0xDF) {
+    return is_utf8_continuation(b1) ? 2 : 0;
+  } else if (b0 >= 0xE0 && b0 <= 0xEF) {
+    const auto min = uint8_t(b0 == 0xE0 ? 0xA0 : 0x80);
+    const auto max = uint8_t(b0 == 0xED ? 0x9F : 0xBF);
+    return (is_utf8_continuation(b1, min, max) && is_utf8_continuation(b2)) ? 3 : 0;
+  } else if (b0 >= 0xF0 && b0 <= 0xF4) {
+    const auto min = uint8_t(b0 == 0xF0 ? 0x90 : 0x80);
+    const auto max = uint8_t(b0 == 0xF4 ? 0x8F : 0xBF);
+    return (is_utf8_continuation(b1, min, max) && is_utf8_continuation(b2) && is_utf8_continuation(b3)) ? 4 : 0;
+  } else {
+    return 0;
+  }
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#pragma once
+
+#include <spotify/json/detail/macros.hpp>
+
+#if defined(json_arch_x86_sse42)
+
+#include <nmmintrin.h>
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+/**
+ * Validates UTF-8 16 bytes at a time with the lookup table algorithm by Keiser
+ * and Lemire ("Validating UTF-8 In Less Than One Instruction Per Byte"). Each
+ * pair of adjacent bytes is classified with three 16 entry tables, indexed by
+ * the high and low nibble of the first byte and the high nibble of the second
+ * byte; the bitwise and of the three is non-zero for any invalid pair. Third
+ * and fourth bytes of longer sequences are checked separately.
+ *
+ * Chunks must be given in order. Bytes after the end of the input should be
+ * zero, so that a sequence that is cut short by the end is reported.
+ */
+class utf8_checker_sse42 final {
+ public:
+  json_force_inline void check(const __m128i input) {
+    if (json_likely(_mm_movemask_epi8(input) == 0)) {
+      _error = _mm_or_si128(_error, _prev_incomplete);
+      _prev_incomplete = _mm_setzero_si128();
+    } else {
+      check_multibyte_lengths(input);
+      _prev_incomplete = is_incomplete(input);
+    }
+    _prev_input = input;
+  }
+
+  /**
+   * Report a sequence that is cut short by the end of the last chunk.
+   */
+  json_force_inline void check_eof() {
+    _error = _mm_or_si128(_error, _prev_incomplete);
+  }
+
+  json_force_inline bool has_error() const {
+    return !_mm_testz_si128(_error, _error);
+  }
+
+ private:
+  static json_force_inline __m128i high_nibbles(const __m128i v) {
+    return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+  }
+
+  static json_force_inline __m128i check_special_cases(const __m128i input, const __m128i prev1) {
+    constexpr char TOO_SHORT = 1 << 0;       // 11______ 0_______ or 11______ 11______
+    constexpr char TOO_LONG = 1 << 1;        // 0_______ 10______
+    constexpr char OVERLONG_3 = 1 << 2;      // 11100000 100_____
+    constexpr char TOO_LARGE = 1 << 3;       // 11110100 1001____ and above
+    constexpr char SURROGATE = 1 << 4;       // 11101101 101_____
+    constexpr char OVERLONG_2 = 1 << 5;      // 1100000_ 10______
+    constexpr char TOO_LARGE_1000 = 1 << 6;  // 11110101 1000____ and above
+    constexpr char OVERLONG_4 = 1 << 6;      // 11110000 1000____
+    constexpr char TWO_CONTS = char(1 << 7);  // 10______ 10______
+    constexpr char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    const auto byte_1_high = _mm_shuffle_epi8(_mm_setr_epi8(
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4), high_nibbles(prev1));
+
+    const auto byte_1_low = _mm_shuffle_epi8(_mm_setr_epi8(
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000), _mm_and_si128(prev1, _mm_set1_epi8(0x0F)));
+
+    const auto byte_2_high = _mm_shuffle_epi8(_mm_setr_epi8(
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT), high_nibbles(input));
+
+    return _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+  }
+
+  json_force_inline void check_multibyte_lengths(const __m128i input) {
+    const auto prev1 = _mm_alignr_epi8(input, _prev_input, 15);
+    const auto prev2 = _mm_alignr_epi8(input, _prev_input, 14);
+    const auto prev3 = _mm_alignr_epi8(input, _prev_input, 13);
+    const auto special_cases = check_special_cases(input, prev1);
+
+    // Bytes that are two or three positions after a three or four byte lead
+    // must be continuation bytes. The special cases have the continuation bit
+    // (TWO_CONTS) set exactly for the pairs of continuation bytes, so the xor
+    // is non-zero where the two disagree.
+    const auto is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80)));
+    const auto is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80)));
+    const auto must_be_2_3_continuation = _mm_and_si128(
+        _mm_or_si128(is_third_byte, is_fourth_byte),
+        _mm_set1_epi8(char(0x80)));
+    _error = _mm_or_si128(_error, _mm_xor_si128(must_be_2_3_continuation, special_cases));
+  }
+
+  static json_force_inline __m128i is_incomplete(const __m128i input) {
+    // Non-zero if the last three bytes start a sequence that does not fit.
+    const auto max_value = _mm_setr_epi8(
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF),
+        char(0xFF), char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+    return _mm_subs_epu8(input, max_value);
+  }
+
+  __m128i _error = _mm_setzero_si128();
+  __m128i _prev_input = _mm_setzero_si128();
+  __m128i _prev_incomplete = _mm_setzero_si128();
+};
+
+/**
+ * Return the index of the lowest set bit of a non-zero movemask result.
+ */
+json_force_inline unsigned count_trailing_zeros(const unsigned mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif  // defined(_MSC_VER)
+}
+
+/**
+ * Load the first n (at most 16) bytes at pos, with the rest of the chunk set
+ * to zero, without reading past pos + n.
+ */
+json_force_inline __m128i load_partial_16(const char *pos, const size_t n) {
+  alignas(16) char buffer[16] = { 0 };
+  for (size_t i = 0; i < n; i++) {
+    buffer[i] = pos[i];
+  }
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(&buffer[0]));
+}
+
+/**
+ * Set all bytes from index n (at most 16) onwards to zero.
+ */
+json_force_inline __m128i keep_first_n(const __m128i chunk, const size_t n) {
+  alignas(16) static const char MASKS[32] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  };
+  const auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&MASKS[16 - n]));
+  return _mm_and_si128(chunk, mask);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
+
+#endif  // defined(json_arch_x86_sse42)
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <limits>
 #include <spotify/json/detail/cpuid.hpp>
+#include <spotify/json/slow_path_counters.hpp>
 
 namespace spotify {
 namespace json {
@@ -48,6 +49,8 @@ std::unique_ptr<void, decltype(std::free) *> encode_context::steal_data() {
 }
 
 char *encode_context::grow_buffer(const std::size_t num_bytes) {
+  json_count_slow_path(grow_buffer);
+
   const auto old_size = size();
   const auto new_size = std::size_t(old_size + num_bytes);
   if (json_unlikely(new_size < old_size)) {
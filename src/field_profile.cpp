@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/field_profile.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "detail/thread_registry.hpp"
+
+namespace spotify {
+namespace json {
+namespace detail {
+
+std::atomic<bool> field_profiling(false);
+
+}  // namespace detail
+
+namespace {
+
+struct thread_field_counters {
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> nanoseconds{0};
+  std::atomic<uint64_t> self_nanoseconds{0};
+};
+
+/**
+ * A field in the tree of fields that one thread has profiled, where the
+ * children of a field are the fields nested in it. Fields are looked up by
+ * name among the children of the field that is being decoded or encoded, so
+ * the path of a field is only built when the profile is read.
+ *
+ * The counters that reset_field_profile has last seen are kept, and
+ * subtracted when the profile is read, so that resetting the profile does not
+ * write to the counters of other threads.
+ */
+struct field_node {
+  explicit field_node(std::string node_name) : name(std::move(node_name)) {}
+
+  const std::string name;
+  std::vector<std::unique_ptr<field_node>> children;
+  size_t last_child = 0;  // only used by the owning thread
+  thread_field_counters decode;
+  thread_field_counters encode;
+  field_profile_counters reset_decode;
+  field_profile_counters reset_encode;
+};
+
+/**
+ * The fields that one thread has profiled. The mutex is only taken by the
+ * owning thread to add a field to the tree, so that other threads can walk it.
+ * The path holds the fields that the thread is decoding or encoding, below the
+ * root, and for each of them nested_nanoseconds holds the time spent in the
+ * profiled fields nested in it so far, which is subtracted to get its self time.
+ */
+struct thread_field_profile {
+  mutable std::mutex mutex;
+  field_node root{std::string()};
+  std::vector<field_node *> path{ &root };
+  std::vector<uint64_t> nested_nanoseconds;
+};
+
+field_profile_counters read_counters(
+    const thread_field_counters &counters,
+    const field_profile_counters &reset) {
+  field_profile_counters result;
+  result.calls = counters.calls.load(std::memory_order_relaxed) - reset.calls;
+  result.bytes = counters.bytes.load(std::memory_order_relaxed) - reset.bytes;
+  result.nanoseconds = counters.nanoseconds.load(std::memory_order_relaxed) - reset.nanoseconds;
+  result.self_nanoseconds = counters.self_nanoseconds.load(std::memory_order_relaxed) - reset.self_nanoseconds;
+  return result;
+}
+
+void add(field_profile_counters &sum, const field_profile_counters &counters) {
+  sum.calls += counters.calls;
+  sum.bytes += counters.bytes;
+  sum.nanoseconds += counters.nanoseconds;
+  sum.self_nanoseconds += counters.self_nanoseconds;
+}
+
+/**
+ * Add the fields nested in node, which has the given path, to entries. The
+ * mutex of the thread that owns node must be held unless it is the calling
+ * thread.
+ */
+void add_fields(
+    std::map<std::string, field_profile_entry> &entries,
+    const field_node &node,
+    const std::string &path) {
+  for (const auto &child : node.children) {
+    const auto child_path = path.empty() ? child->name : path + '.' + child->name;
+    const auto decode = read_counters(child->decode, child->reset_decode);
+    const auto encode = read_counters(child->encode, child->reset_encode);
+    if (decode.calls || encode.calls) {
+      auto &entry = entries[child_path];
+      entry.path = child_path;
+      add(entry.decode, decode);
+      add(entry.encode, encode);
+    }
+    add_fields(entries, *child, child_path);
+  }
+}
+
+void reset_fields(field_node &node) {
+  for (const auto &child : node.children) {
+    child->reset_decode = read_counters(child->decode, field_profile_counters());
+    child->reset_encode = read_counters(child->encode, field_profile_counters());
+    reset_fields(*child);
+  }
+}
+
+void add(std::map<std::string, field_profile_entry> &entries, const thread_field_profile &thread) {
+  std::lock_guard<std::mutex> lock(thread.mutex);
+  add_fields(entries, thread.root, std::string());
+}
+
+using field_profile_registry = detail::thread_registry<
+    thread_field_profile,
+    std::map<std::string, field_profile_entry>,
+    add>;
+
+/**
+ * Find the child of parent with the given name, adding it if there is none.
+ * Objects are usually decoded and encoded with their fields in the same order
+ * every time, so the search starts after the child that was found last.
+ */
+field_node &find_child(
+    thread_field_profile &thread,
+    field_node &parent,
+    const char *name,
+    const size_t name_size) {
+  auto &children = parent.children;
+  for (size_t i = 0; i < children.size(); i++) {
+    const auto index = (parent.last_child + 1 + i) % children.size();
+    const auto &child = *children[index];
+    if (child.name.size() == name_size && std::memcmp(child.name.data(), name, name_size) == 0) {
+      parent.last_child = index;
+      return *children[index];
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(thread.mutex);
+  children.push_back(std::make_unique<field_node>(std::string(name, name_size)));
+  parent.last_child = children.size() - 1;
+  return *children.back();
+}
+
+void write_profile_table(
+    std::ostream &stream,
+    const char *title,
+    std::vector<std::pair<std::string, field_profile_counters>> rows) {
+  uint64_t total = 0;
+  for (const auto &row : rows) {
+    total += row.second.self_nanoseconds;
+  }
+  if (!total) {
+    return;
+  }
+
+  std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) {
+    return a.second.nanoseconds > b.second.nanoseconds;
+  });
+
+  const auto percent = [&](const uint64_t nanoseconds) {
+    return (100.0 * nanoseconds) / total;
+  };
+
+  stream
+      << title << " (" << (total / 1e6) << " ms)\n"
+      << std::setw(8) << "time %" << std::setw(8) << "self %"
+      << std::setw(12) << "calls" << std::setw(14) << "bytes" << "  field\n";
+  for (const auto &row : rows) {
+    stream
+        << std::fixed << std::setprecision(1)
+        << std::setw(8) << percent(row.second.nanoseconds)
+        << std::setw(8) << percent(row.second.self_nanoseconds)
+        << std::setw(12) << row.second.calls
+        << std::setw(14) << row.second.bytes
+        << "  " << row.first << '\n';
+  }
+  stream << std::defaultfloat << std::setprecision(6);
+}
+
+}  // namespace
+
+void set_field_profiling(const bool enabled) {
+  detail::field_profiling.store(enabled, std::memory_order_relaxed);
+}
+
+std::vector<field_profile_entry> read_field_profile() {
+  auto entries = field_profile_registry::sum();
+  std::vector<field_profile_entry> sorted;
+  sorted.reserve(entries.size());
+  for (auto &entry : entries) {
+    sorted.push_back(std::move(entry.second));
+  }
+  return sorted;
+}
+
+void reset_field_profile() {
+  field_profile_registry::reset([](thread_field_profile &thread) {
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    reset_fields(thread.root);
+  });
+}
+
+void dump_field_profile(std::ostream &stream) {
+  std::vector<std::pair<std::string, field_profile_counters>> decode_rows;
+  std::vector<std::pair<std::string, field_profile_counters>> encode_rows;
+  for (const auto &entry : read_field_profile()) {
+    if (entry.decode.calls) {
+      decode_rows.emplace_back(entry.path, entry.decode);
+    }
+    if (entry.encode.calls) {
+      encode_rows.emplace_back(entry.path, entry.encode);
+    }
+  }
+  write_profile_table(stream, "decode", std::move(decode_rows));
+  write_profile_table(stream, "encode", std::move(encode_rows));
+}
+
+namespace detail {
+
+field_profile_scope::field_profile_scope(
+    const field_profile_operation operation,
+    const char *name,
+    const size_t name_size)
+    : _operation(operation) {
+  auto &thread = field_profile_registry::local();
+  thread.path.push_back(&find_child(thread, *thread.path.back(), name, name_size));
+  thread.nested_nanoseconds.push_back(0);
+  _start = std::chrono::steady_clock::now();
+}
+
+field_profile_scope::~field_profile_scope() {
+  if (json_unlikely(!_finished)) {
+    auto &thread = field_profile_registry::local();
+    thread.path.pop_back();
+    thread.nested_nanoseconds.pop_back();
+  }
+}
+
+void field_profile_scope::finish(const size_t bytes) {
+  using namespace std::chrono;
+  const auto elapsed = uint64_t(duration_cast<nanoseconds>(steady_clock::now() - _start).count());
+  auto &thread = field_profile_registry::local();
+  const auto nested = thread.nested_nanoseconds.back();
+  thread.nested_nanoseconds.pop_back();
+  if (!thread.nested_nanoseconds.empty()) {
+    thread.nested_nanoseconds.back() += elapsed;
+  }
+
+  auto &node = *thread.path.back();
+  thread.path.pop_back();
+  auto &counters = (_operation == field_profile_operation::decode ? node.decode : node.encode);
+  increment(counters.calls, 1);
+  increment(counters.bytes, bytes);
+  increment(counters.nanoseconds, elapsed);
+  increment(counters.self_nanoseconds, elapsed > nested ? elapsed - nested : 0);
+  _finished = true;
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/mapped_file.hpp>
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(_WIN32)
+
+namespace spotify {
+namespace json {
+namespace {
+
+[[noreturn]] void throw_system_error(const int error, const std::string &what) {
+  throw std::system_error(error, std::generic_category(), what);
+}
+
+}  // namespace
+
+#if defined(_WIN32)
+
+mapped_file::mapped_file(const std::string &path) {
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  if (!stream) {
+    throw_system_error(ENOENT, "Could not open " + path);
+  }
+  _buffer = padded_buffer(size_t(stream.tellg()));
+  stream.seekg(0);
+  if (!stream.read(_buffer.data(), _buffer.size())) {
+    throw_system_error(EIO, "Could not read " + path);
+  }
+  _data = _buffer.data();
+  _size = _buffer.size();
+}
+
+void mapped_file::unmap() {}
+
+#else
+
+mapped_file::mapped_file(const std::string &path) {
+  const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw_system_error(errno, "Could not open " + path);
+  }
+
+  struct close_on_exit {
+    ~close_on_exit() { ::close(fd); }
+    int fd;
+  } closer{ fd };
+
+  struct stat status;
+  if (::fstat(fd, &status) == -1) {
+    throw_system_error(errno, "Could not stat " + path);
+  }
+
+  // Reserve room for the file and its padding with anonymous zeroed pages, and
+  // map the file over the start of it. The padding then lies either in the
+  // zero filled end of the last page of the file or in the anonymous pages,
+  // and never in pages past the end of the file, where reads would fault.
+  const auto page_size = size_t(::sysconf(_SC_PAGESIZE));
+  const auto size = size_t(status.st_size);
+  const auto mapped_size = (size + padded_string_view::padding + page_size - 1) / page_size * page_size;
+  const auto base = ::mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    throw_system_error(errno, "Could not map " + path);
+  }
+
+  if (size > 0) {
+    if (::mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      const auto error = errno;
+      ::munmap(base, mapped_size);
+      throw_system_error(error, "Could not map " + path);
+    }
+    ::madvise(base, size, MADV_SEQUENTIAL);  // only a hint, so errors are ignored
+  }
+
+  _data = static_cast<const char *>(base);
+  _size = size;
+  _mapped_size = mapped_size;
+}
+
+void mapped_file::unmap() {
+  if (_mapped_size) {
+    ::munmap(const_cast<char *>(_data), _mapped_size);
+  }
+}
+
+#endif  // defined(_WIN32)
+
+mapped_file::mapped_file(mapped_file &&file) noexcept
+    : _data(std::exchange(file._data, nullptr)),
+      _size(std::exchange(file._size, 0)),
+      _mapped_size(std::exchange(file._mapped_size, 0))
+#if defined(_WIN32)
+      , _buffer(std::move(file._buffer))
+#endif  // defined(_WIN32)
+      {}
+
+mapped_file::~mapped_file() {
+  unmap();
+}
+
+mapped_file &mapped_file::operator=(mapped_file &&file) noexcept {
+  if (this != &file) {
+    unmap();
+    _data = std::exchange(file._data, nullptr);
+    _size = std::exchange(file._size, 0);
+    _mapped_size = std::exchange(file._mapped_size, 0);
+#if defined(_WIN32)
+    _buffer = std::move(file._buffer);
+#endif  // defined(_WIN32)
+  }
+  return *this;
+}
+
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/slow_path_counters.hpp>
+
+#include <atomic>
+
+#include "detail/thread_registry.hpp"
+
+namespace spotify {
+namespace json {
+namespace {
+
+constexpr auto num_slow_paths = static_cast<size_t>(slow_path::num_slow_paths);
+
+using thread_counters = std::array<std::atomic<uint64_t>, num_slow_paths>;
+
+void add(slow_path_counts &sum, const thread_counters &counters) {
+  for (size_t i = 0; i < num_slow_paths; i++) {
+    sum.counts[i] += counters[i].load(std::memory_order_relaxed);
+  }
+}
+
+using counters_registry = detail::thread_registry<thread_counters, slow_path_counts, add>;
+
+}  // namespace
+
+const char *slow_path_name(const slow_path path) {
+  switch (path) {
+    case slow_path::decode_integer_tricky: return "decode_integer_tricky";
+    case slow_path::decode_escaped_string: return "decode_escaped_string";
+    case slow_path::stack_spill: return "stack_spill";
+    case slow_path::bitset_spill: return "bitset_spill";
+    case slow_path::grow_buffer: return "grow_buffer";
+    case slow_path::scalar_fallback: return "scalar_fallback";
+    case slow_path::num_slow_paths: break;
+  }
+  return "unknown";
+}
+
+slow_path_counts read_slow_path_counters() {
+  return counters_registry::sum();
+}
+
+namespace detail {
+
+void count_slow_path(const slow_path path) {
+  increment(counters_registry::local()[static_cast<size_t>(path)], 1);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <spotify/json/stats.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+#include "detail/thread_registry.hpp"
+
+namespace spotify {
+namespace json {
+namespace {
+
+struct thread_operation_stats {
+  std::atomic<uint64_t> documents{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> failures{0};
+  std::array<std::atomic<uint64_t>, latency_histogram::num_buckets> latency{};
+};
+
+void add(operation_stats &sum, const thread_operation_stats &stats) {
+  sum.documents += stats.documents.load(std::memory_order_relaxed);
+  sum.bytes += stats.bytes.load(std::memory_order_relaxed);
+  sum.failures += stats.failures.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < latency_histogram::num_buckets; i++) {
+    sum.latency.counts[i] += stats.latency[i].load(std::memory_order_relaxed);
+  }
+}
+
+struct thread_stats {
+  thread_operation_stats decode;
+  thread_operation_stats encode;
+};
+
+void add(stats &sum, const thread_stats &thread) {
+  add(sum.decode, thread.decode);
+  add(sum.encode, thread.encode);
+}
+
+using stats_registry = detail::thread_registry<thread_stats, stats, add>;
+
+#if defined(__GNUC__)
+json_force_inline size_t highest_bit(const uint64_t value) {
+  return size_t(63 - __builtin_clzll(value));
+}
+#else
+json_force_inline size_t highest_bit(uint64_t value) {
+  size_t bit = 0;
+  while (value >>= 1) {
+    bit++;
+  }
+  return bit;
+}
+#endif  // defined(__GNUC__)
+
+}  // namespace
+
+size_t latency_histogram::bucket(const uint64_t nanoseconds) {
+  if (nanoseconds < (uint64_t(1) << sub_bucket_bits)) {
+    return size_t(nanoseconds);
+  }
+
+  const auto exponent = highest_bit(nanoseconds);
+  if (exponent >= max_exponent) {
+    return num_buckets - 1;
+  }
+
+  const auto sub_bucket = (nanoseconds >> (exponent - sub_bucket_bits)) & ((1 << sub_bucket_bits) - 1);
+  return ((exponent - sub_bucket_bits + 1) << sub_bucket_bits) + size_t(sub_bucket);
+}
+
+uint64_t latency_histogram::bucket_lower_bound(const size_t bucket) {
+  if (bucket < (size_t(1) << sub_bucket_bits)) {
+    return bucket;
+  }
+
+  const auto exponent = (bucket >> sub_bucket_bits) + sub_bucket_bits - 1;
+  const auto sub_bucket = bucket & ((1 << sub_bucket_bits) - 1);
+  return uint64_t((size_t(1) << sub_bucket_bits) + sub_bucket) << (exponent - sub_bucket_bits);
+}
+
+uint64_t latency_histogram::count() const {
+  uint64_t sum = 0;
+  for (const auto count : counts) {
+    sum += count;
+  }
+  return sum;
+}
+
+uint64_t latency_histogram::percentile(const double fraction) const {
+  const auto total = count();
+  if (!total) {
+    return 0;
+  }
+
+  const auto rank = std::max(uint64_t(1), uint64_t(fraction * total + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < num_buckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bucket_lower_bound(i);
+    }
+  }
+  return bucket_lower_bound(num_buckets - 1);
+}
+
+stats read_stats() {
+  return stats_registry::sum();
+}
+
+namespace detail {
+
+void record_stats(
+    const stats_operation operation,
+    const size_t bytes,
+    const bool failed,
+    const uint64_t nanoseconds) {
+  auto &thread = stats_registry::local();
+  auto &stats = (operation == stats_operation::decode ? thread.decode : thread.encode);
+  if (json_likely(!failed)) {
+    increment(stats.documents, 1);
+    increment(stats.bytes, bytes);
+  } else {
+    increment(stats.failures, 1);
+  }
+  increment(stats.latency[latency_histogram::bucket(nanoseconds)], 1);
+}
+
+}  // namespace detail
+}  // namespace json
+}  // namespace spotify
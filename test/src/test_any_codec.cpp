@@ -14,10 +14,19 @@
  * the License.
  */
 
+#include <string>
+#include <type_traits>
+#include <utility>
+
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/codec/any_codec.hpp>
 #include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/eq.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
 
 #include <spotify/json/test/only_true.hpp>
@@ -37,6 +46,16 @@ bool any_parse(const char *str) {
   return result;
 }
 
+struct any_track_t {
+  std::string title;
+};
+
+object_t<any_track_t> any_track_codec() {
+  auto codec = object<any_track_t>();
+  codec.required("title", &any_track_t::title);
+  return codec;
+}
+
 }  // namespace
 
 BOOST_AUTO_TEST_CASE(json_any_should_encode) {
@@ -60,6 +79,55 @@ BOOST_AUTO_TEST_CASE(json_any_should_respect_should_encode) {
   BOOST_CHECK(!codec.should_encode(false));
 }
 
+BOOST_AUTO_TEST_CASE(json_any_should_be_small) {
+  BOOST_CHECK_EQUAL(sizeof(any_codec_t<bool>), sizeof(void *) + any_codec_t<bool>::inline_size);
+  BOOST_CHECK(std::is_nothrow_move_constructible<any_codec_t<bool>>::value);
+}
+
+BOOST_AUTO_TEST_CASE(json_any_should_hold_codecs_that_do_not_fit_inline) {
+  const auto codec = any_codec(any_track_codec());
+  BOOST_CHECK_EQUAL(decode(codec, R"({"title":"a"})").title, "a");
+  BOOST_CHECK_EQUAL(encode(codec, any_track_t{ "b" }), R"({"title":"b"})");
+  BOOST_CHECK_THROW(decode(codec, R"({})"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_any_should_copy_lvalue_codecs) {
+  auto codec = any_codec_t<std::string>(string());
+  {
+    const auto strict_codec = eq(std::string("x"));
+    codec = any_codec(strict_codec);
+  }
+  BOOST_CHECK_EQUAL(decode(codec, R"("x")"), "x");
+  BOOST_CHECK_THROW(decode(codec, R"("y")"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_any_should_be_copyable_and_movable) {
+  auto small = any_codec(only_true_t());
+  auto large = any_codec(eq(std::string("x")));
+
+  auto small_copy = small;
+  auto large_copy = large;
+  BOOST_CHECK(!small_copy.should_encode(false));
+  BOOST_CHECK_EQUAL(decode(large_copy, R"("x")"), "x");
+
+  const auto small_moved = std::move(small_copy);
+  const auto large_moved = std::move(large_copy);
+  BOOST_CHECK(small_moved.should_encode(true));
+  BOOST_CHECK_THROW(decode(large_moved, R"("y")"), decode_exception);
+
+  large_copy = large_moved;
+  large_copy = any_codec(string());
+  BOOST_CHECK_EQUAL(decode(large_copy, R"("y")"), "y");
+  BOOST_CHECK_EQUAL(decode(large, R"("x")"), "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_any_should_not_wrap_any_codecs) {
+  auto codec = any_codec(boolean());
+  auto copy = any_codec(codec);
+  BOOST_CHECK((std::is_same<decltype(copy), any_codec_t<bool>>::value));
+  BOOST_CHECK_EQUAL(encode(copy, true), "true");
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,7 +14,10 @@
  * the License.
  */
 
+#include <array>
+#include <list>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -24,6 +27,7 @@
 #include <spotify/json/codec/boolean.hpp>
 #include <spotify/json/codec/number.hpp>
 #include <spotify/json/codec/omit.hpp>
+#include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
@@ -231,6 +235,101 @@ BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_empty_unordered_set) {
   BOOST_CHECK(array_parse<std::unordered_set<bool>>("[]").empty());
 }
 
+/*
+ * Decoding Into
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_vector) {
+  std::vector<std::string> vector = { "abcdefghijklmnopqrstuvwxyz0", "b" };
+  const auto data = vector[0].data();
+  decode_into(R"(["a","b","c"])", vector);
+  BOOST_CHECK((vector == std::vector<std::string>{ "a", "b", "c" }));
+  decode_into(R"(["abcdefghijklmnopqrstuvwxyz1"])", vector);
+  BOOST_CHECK((vector == std::vector<std::string>{ "abcdefghijklmnopqrstuvwxyz1" }));
+  BOOST_CHECK_EQUAL(static_cast<const void *>(vector[0].data()), static_cast<const void *>(data));
+  decode_into("[]", vector);
+  BOOST_CHECK(vector.empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_vector_of_bools) {
+  std::vector<bool> vector = { false, false, false };
+  decode_into("[true,false]", vector);
+  BOOST_CHECK((vector == std::vector<bool>{ true, false }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_list) {
+  std::list<int> list = { 1, 2, 3 };
+  decode_into("[4,5]", list);
+  BOOST_CHECK((list == std::list<int>{ 4, 5 }));
+  decode_into("[6,7,8,9]", list);
+  BOOST_CHECK((list == std::list<int>{ 6, 7, 8, 9 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_array) {
+  std::array<int, 2> array = {{ 1, 2 }};
+  decode_into("[3,4]", array);
+  BOOST_CHECK((array == std::array<int, 2>{{ 3, 4 }}));
+  BOOST_CHECK_THROW(decode_into("[5]", array), decode_exception);
+  BOOST_CHECK_THROW(decode_into("[5,6,7]", array), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_array_should_decode_into_set) {
+  std::unordered_set<int> set = { 1, 2 };
+  decode_into("[2,3]", set);
+  BOOST_CHECK((set == std::unordered_set<int>{ 2, 3 }));
+}
+
+/*
+ * Counted Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_counted_array_should_decode_empty_vector) {
+  const auto codec = counted_array<std::vector<std::string>>(string());
+  const auto decoded = decode(codec, "[]");
+  BOOST_CHECK(decoded.empty());
+  BOOST_CHECK_EQUAL(decoded.capacity(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_counted_array_should_reserve_vector) {
+  const auto codec = counted_array<std::vector<std::string>>(string());
+  const auto decoded = decode(codec, R"([ "a" , "b,]" , "c" ])");
+  BOOST_CHECK((decoded == std::vector<std::string>{ "a", "b,]", "c" }));
+  BOOST_CHECK_EQUAL(decoded.capacity(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_counted_array_should_reserve_vector_of_nested_values) {
+  const auto codec = counted_array<std::vector<encoded_value>>(default_codec<encoded_value>());
+  const auto decoded = decode(codec, R"([[1,[2]],{"a":[3,4],"b":"]"},"x"])");
+  BOOST_CHECK_EQUAL(decoded.size(), 3);
+  BOOST_CHECK_EQUAL(decoded.capacity(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_counted_array_should_decode_unordered_set) {
+  const auto codec = counted_array<std::unordered_set<int>>(number<int>());
+  BOOST_CHECK((decode(codec, "[1,2,3,2]") == std::unordered_set<int>{ 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_counted_array_should_decode_deque) {
+  const auto codec = counted_array<std::deque<int>>(number<int>());
+  BOOST_CHECK((decode(codec, "[1,2]") == std::deque<int>{ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_counted_array_should_not_decode_otherwise) {
+  const auto codec = counted_array<std::vector<bool>>(boolean());
+  for (const auto json : { "", "[", "[[", "[false", "[false,true,]", "[false,true,", "[false true]" }) {
+    auto context = decode_context(json, json + strlen(json));
+    BOOST_CHECK_THROW(codec.decode(context), decode_exception);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_counted_array_should_not_reserve_more_than_the_input_allows) {
+  // Reserving one 64 KiB element per comma would reserve 64 GiB
+  using big_t = std::array<char, 1 << 16>;
+  const auto codec = counted_array<std::vector<big_t>>(array<big_t>(number<char>()));
+  const auto json = "[" + std::string(1 << 20, ',') + "]";
+  BOOST_CHECK_THROW(decode(codec, json), decode_exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
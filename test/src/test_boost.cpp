@@ -239,6 +239,26 @@ BOOST_AUTO_TEST_CASE(json_codec_flat_map_should_decode) {
               (boost::container::flat_map<std::string, int>{{"foo", 1234}}));
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_flat_map_should_decode_unsorted_keys) {
+  BOOST_CHECK((decode<boost::container::flat_map<std::string, int>>(R"({"c":3,"a":1,"b":2})")) ==
+              (boost::container::flat_map<std::string, int>{{"a", 1}, {"b", 2}, {"c", 3}}));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_flat_map_should_decode_first_of_duplicate_keys) {
+  BOOST_CHECK((decode<boost::container::flat_map<std::string, int>>(R"({"b":1,"a":2,"b":3,"a":4})")) ==
+              (boost::container::flat_map<std::string, int>{{"a", 2}, {"b", 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_flat_map_should_decode_empty_map) {
+  BOOST_CHECK((decode<boost::container::flat_map<std::string, int>>("{}").empty()));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_flat_map_should_decode_into_existing_map) {
+  boost::container::flat_map<std::string, int> map{{"a", 1}, {"b", 2}};
+  decode_into(R"({"c":3,"a":4})", map);
+  BOOST_CHECK((map == boost::container::flat_map<std::string, int>{{"a", 4}, {"c", 3}}));
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_flat_map_should_encode) {
   BOOST_CHECK_EQUAL((encode(boost::container::flat_map<std::string, int>{{"foo", 1234}})),
                     "{\"foo\":1234}");
@@ -123,6 +123,38 @@ BOOST_AUTO_TEST_CASE(json_decode_should_throw_on_unexpected_trailing_input) {
   BOOST_CHECK_THROW(decode<custom_obj>(R"({"x":"h"} invalid)"), decode_exception);
 }
 
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_from_bytes_with_custom_codec) {
+  static const char * const kData = R"({"a":"e"})";
+  custom_obj obj;
+  decode_into(custom_codec(), kData, strlen(kData), obj);
+  BOOST_CHECK_EQUAL(obj.val, "e");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_from_bytes) {
+  static const char * const kData = "53";
+  int val = 0;
+  decode_into(kData, strlen(kData), val);
+  BOOST_CHECK_EQUAL(val, 53);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_from_cstring_with_custom_codec) {
+  custom_obj obj;
+  decode_into(custom_codec(), R"({"a":"e"})", obj);
+  BOOST_CHECK_EQUAL(obj.val, "e");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_decode_from_std_string) {
+  custom_obj obj;
+  decode_into(std::string(R"( {"x":"e"} )"), obj);
+  BOOST_CHECK_EQUAL(obj.val, "e");
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_into_should_throw_on_failure) {
+  custom_obj obj;
+  BOOST_CHECK_THROW(decode_into("{}", obj), decode_exception);
+  BOOST_CHECK_THROW(decode_into(R"({"x":"h"} invalid)", obj), decode_exception);
+}
+
 BOOST_AUTO_TEST_CASE(json_try_decode_should_decode_from_bytes_with_custom_codec) {
   static const char * const kData = R"({"a":"e"})";
   custom_obj obj;
@@ -223,5 +255,30 @@ BOOST_AUTO_TEST_CASE(json_try_decode_should_accept_utf8) {
   BOOST_CHECK_EQUAL(u8"\u9E21", obj.val);
 }
 
+BOOST_AUTO_TEST_CASE(json_decode_should_validate_utf8_with_options) {
+  const auto json = std::string("{\"x\":\"\xC0\xAF\"}");  // overlong '/'
+  decode_options options;
+  options.validate_utf8 = true;
+  BOOST_CHECK_NO_THROW(decode<custom_obj>(json));
+  BOOST_CHECK_THROW(decode<custom_obj>(json, options), decode_exception);
+  BOOST_CHECK_THROW(decode<custom_obj>(json.c_str(), options), decode_exception);
+  BOOST_CHECK_THROW(decode<custom_obj>(json.data(), json.size(), options), decode_exception);
+  BOOST_CHECK_THROW(decode(custom_codec(), std::string("{\"a\":\"\xC0\xAF\"}"), options), decode_exception);
+  BOOST_CHECK_EQUAL(decode<custom_obj>(u8"{\"x\":\"\u9E21\"}", options).val, u8"\u9E21");
+}
+
+BOOST_AUTO_TEST_CASE(json_try_decode_should_validate_utf8_with_options) {
+  const auto json = std::string("{\"x\":\"\xC0\xAF\"}");  // overlong '/'
+  decode_options options;
+  options.validate_utf8 = true;
+  custom_obj obj;
+  BOOST_CHECK(try_decode(obj, json));
+  BOOST_CHECK(!try_decode(obj, json, options));
+  BOOST_CHECK(!try_decode(obj, json.c_str(), options));
+  BOOST_CHECK(!try_decode(obj, json.data(), json.size(), options));
+  BOOST_CHECK(!try_decode(obj, custom_codec(), std::string("{\"a\":\"\xC0\xAF\"}"), options));
+  BOOST_CHECK(try_decode(obj, u8"{\"x\":\"\u9E21\"}", options));
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -92,6 +92,42 @@ BOOST_AUTO_TEST_CASE(json_decode_helpers_peek_2_too_short) {
   BOOST_CHECK(!peek_2(make_context("b"), 'a', 'b'));
 }
 
+/*
+ * Tokens
+ */
+
+BOOST_AUTO_TEST_CASE(json_decode_helpers_peek_token) {
+  BOOST_CHECK_EQUAL(peek_token(make_context("{}")), token_object);
+  BOOST_CHECK_EQUAL(peek_token(make_context("[]")), token_array);
+  BOOST_CHECK_EQUAL(peek_token(make_context("\"\"")), token_string);
+  BOOST_CHECK_EQUAL(peek_token(make_context("-1")), token_number);
+  BOOST_CHECK_EQUAL(peek_token(make_context("0")), token_number);
+  BOOST_CHECK_EQUAL(peek_token(make_context("9")), token_number);
+  BOOST_CHECK_EQUAL(peek_token(make_context("true")), token_boolean);
+  BOOST_CHECK_EQUAL(peek_token(make_context("false")), token_boolean);
+  BOOST_CHECK_EQUAL(peek_token(make_context("null")), token_null);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_helpers_peek_token_with_invalid_input) {
+  BOOST_CHECK_EQUAL(peek_token(make_context("")), token_none);
+  BOOST_CHECK_EQUAL(peek_token(make_context("x")), token_none);
+  BOOST_CHECK_EQUAL(peek_token(make_context("}")), token_none);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_helpers_accepted_tokens) {
+  BOOST_CHECK_EQUAL(accepted_tokens(codec::boolean()), token_boolean);
+  BOOST_CHECK_EQUAL(accepted_tokens(codec::string()), token_string);
+  BOOST_CHECK_EQUAL(accepted_tokens(codec::omit<bool>()), token_none);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_helpers_accepted_tokens_by_default) {
+  struct any_t {
+    using object_type = bool;
+    object_type decode(decode_context &) const { return true; }
+  };
+  BOOST_CHECK_EQUAL(accepted_tokens(any_t()), token_any);
+}
+
 /*
  * Next
  */
@@ -109,6 +109,25 @@ BOOST_AUTO_TEST_CASE(json_codec_empty_as_with_eq) {
   BOOST_CHECK(test_decode(codec, "123") == 123);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_empty_as_should_report_inner_codec_error) {
+  const auto codec = empty_as_null(number<int>());
+  try {
+    decode(codec, "nul");
+    BOOST_FAIL("decode should have failed");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.what(), "Invalid integer");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_empty_as_should_have_union_of_accepted_tokens) {
+  BOOST_CHECK_EQUAL(
+      empty_as_null(string()).accepted_tokens(),
+      detail::token_string | detail::token_null);
+  BOOST_CHECK_EQUAL(
+      empty_as_omit(string()).accepted_tokens(),
+      detail::token_string);
+}
+
 /*
  * Encoding
  */
@@ -68,6 +68,19 @@ BOOST_AUTO_TEST_CASE(json_encode_should_encode_into_string) {
   BOOST_CHECK_EQUAL(encode(obj), R"({"x":"d"})");
 }
 
+BOOST_AUTO_TEST_CASE(json_encode_should_validate_utf8_with_options) {
+  custom_obj obj;
+  obj.val = "\xC0\xAF";  // overlong '/'
+  encode_options options;
+  options.validate_utf8 = true;
+  BOOST_CHECK_NO_THROW(encode(obj));
+  BOOST_CHECK_THROW(encode(obj, options), encode_exception);
+  BOOST_CHECK_THROW(encode(custom_codec(), obj, options), encode_exception);
+
+  obj.val = u8"\u9E21";
+  BOOST_CHECK_EQUAL(encode(obj, options), u8"{\"x\":\"\u9E21\"}");
+}
+
 /*
  * json::encode_value
  */
@@ -18,8 +18,9 @@
 
 #include <boost/test/unit_test.hpp>
 
-#include <spotify/json/codec/string.hpp>
 #include <spotify/json/codec/enumeration.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 #include <spotify/json/encode_exception.hpp>
@@ -49,6 +50,31 @@ enum class Test {
   B
 };
 
+/**
+ * A type that can only be compared with ==, so that enumeration_t has to fall
+ * back to linear searches.
+ */
+struct Unordered {
+  int value;
+
+  bool operator==(const Unordered &other) const {
+    return value == other.value;
+  }
+};
+
+std::string country_code(const int i) {
+  const char code[] = { char('A' + i / 26), char('A' + i % 26) };
+  return std::string(code, 2);
+}
+
+enumeration_t<int, string_t> country_codec() {
+  std::vector<std::pair<int, std::string>> mapping;
+  for (int i = 0; i < 250; i++) {
+    mapping.emplace_back(i, country_code(i));
+  }
+  return enumeration_t<int, string_t>(string(), std::move(mapping));
+}
+
 }  // namespace
 
 /*
@@ -94,6 +120,52 @@ BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_not_decode_invalid_value) {
   test_decode_fail(codec, "\"B\"");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_decode_large_enumeration) {
+  const auto codec = country_codec();
+  for (int i = 0; i < 250; i++) {
+    BOOST_CHECK_EQUAL(test_decode(codec, "\"" + country_code(i) + "\""), i);
+  }
+  test_decode_fail(codec, "\"ZZ\"");
+  test_decode_fail(codec, "\"A\"");
+  test_decode_fail(codec, "\"AAA\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_decode_escaped_string) {
+  const auto codec = enumeration<Test, std::string>({
+      { Test::A, "A\"" },
+      { Test::B, "B" } });
+  BOOST_CHECK(test_decode(codec, "\"A\\\"\"") == Test::A);
+  BOOST_CHECK(test_decode(codec, "\"\\u0042\"") == Test::B);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_not_decode_invalid_string) {
+  const auto codec = enumeration<Test, std::string>({ { Test::A, "A" } });
+  test_decode_fail(codec, "A");
+  test_decode_fail(codec, "\"A");
+  test_decode_fail(codec, "\"A\\");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_decode_first_mapping_of_value) {
+  const auto codec = enumeration<Test, std::string>({
+      { Test::B, "X" },
+      { Test::A, "X" } });
+  BOOST_CHECK(test_decode(codec, "\"X\"") == Test::B);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_decode_with_number_codec) {
+  const auto codec = enumeration<Test>(number<int>(), { { Test::A, 10 }, { Test::B, 5 } });
+  BOOST_CHECK(test_decode(codec, "10") == Test::A);
+  BOOST_CHECK(test_decode(codec, "5") == Test::B);
+  test_decode_fail(codec, "7");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_decode_unordered_type) {
+  const auto codec = enumeration<Unordered>(number<int>(), { { Unordered{ 1 }, 10 }, { Unordered{ 2 }, 5 } });
+  BOOST_CHECK_EQUAL(test_decode(codec, "10").value, 1);
+  BOOST_CHECK_EQUAL(test_decode(codec, "5").value, 2);
+  test_decode_fail(codec, "7");
+}
+
 /*
  * Encoding
  */
@@ -111,6 +183,57 @@ BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_not_encode_missing_value) {
   BOOST_CHECK_THROW(encode(codec, Test::B), encode_exception);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_encode_large_enumeration) {
+  const auto codec = country_codec();
+  for (int i = 0; i < 250; i++) {
+    BOOST_CHECK_EQUAL(encode(codec, i), "\"" + country_code(i) + "\"");
+  }
+  BOOST_CHECK_THROW(encode(codec, -1), encode_exception);
+  BOOST_CHECK_THROW(encode(codec, 250), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_encode_sparse_values) {
+  const auto codec = enumeration<int, std::string>({
+      { -1000000, "min" },
+      { 0, "zero" },
+      { 1000000, "max" } });
+  BOOST_CHECK_EQUAL(encode(codec, -1000000), "\"min\"");
+  BOOST_CHECK_EQUAL(encode(codec, 0), "\"zero\"");
+  BOOST_CHECK_EQUAL(encode(codec, 1000000), "\"max\"");
+  BOOST_CHECK_THROW(encode(codec, 1), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_encode_negative_and_unsigned_values) {
+  const auto signed_codec = enumeration<int, std::string>({ { -2, "a" }, { 3, "b" } });
+  BOOST_CHECK_EQUAL(encode(signed_codec, -2), "\"a\"");
+  BOOST_CHECK_EQUAL(encode(signed_codec, 3), "\"b\"");
+  BOOST_CHECK_THROW(encode(signed_codec, -3), encode_exception);
+
+  const auto unsigned_codec = enumeration<uint64_t, std::string>({ { uint64_t(-1), "a" }, { 0, "b" } });
+  BOOST_CHECK_EQUAL(encode(unsigned_codec, uint64_t(-1)), "\"a\"");
+  BOOST_CHECK_EQUAL(encode(unsigned_codec, 0), "\"b\"");
+  BOOST_CHECK_THROW(encode(unsigned_codec, 1), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_encode_first_mapping_of_value) {
+  const auto codec = enumeration<Test, std::string>({
+      { Test::A, "X" },
+      { Test::A, "Y" } });
+  BOOST_CHECK_EQUAL(encode(codec, Test::A), "\"X\"");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_encode_unordered_type) {
+  const auto codec = enumeration<Unordered>(number<int>(), { { Unordered{ 1 }, 10 }, { Unordered{ 2 }, 5 } });
+  BOOST_CHECK_EQUAL(encode(codec, Unordered{ 1 }), "10");
+  BOOST_CHECK_EQUAL(encode(codec, Unordered{ 2 }), "5");
+  BOOST_CHECK_THROW(encode(codec, Unordered{ 3 }), encode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_enumeration_should_not_encode_with_empty_mapping) {
+  const enumeration_t<Test, string_t> codec(string(), std::vector<std::pair<Test, std::string>>());
+  BOOST_CHECK(!codec.should_encode(Test::A));
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,6 +14,7 @@
  * the License.
  */
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -22,6 +23,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/detail/escape.hpp>
+#include <spotify/json/encode_exception.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
 BOOST_AUTO_TEST_SUITE(json)
@@ -64,6 +66,97 @@ BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_other_control_characters)
   }
 }
 
+std::string escaped(const bool use_sse, const std::string &input) {
+  encode_context context;
+  *const_cast<bool *>(&context.has_sse42) &= use_sse;
+  write_escaped(context, input.data(), input.data() + input.size());
+  return std::string(context.data(), context.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_stay_within_an_exactly_sized_buffer) {
+  // A final chunk that is escaped in full needs all of the 6 bytes per input
+  // byte that are reserved, and must not write past them. This is checked by
+  // the address sanitizer.
+  alignas(16) char input[16];
+  std::memset(input, 0x01, sizeof(input));
+  const auto expected = [] {
+    std::string expected;
+    for (int i = 0; i < 16; i++) {
+      expected += "\\u0001";
+    }
+    return expected;
+  }();
+
+  for (const auto validate_utf8 : { false, true }) {
+    encode_context context(6 * sizeof(input));
+    context.validate_utf8 = validate_utf8;
+    write_escaped(context, input, input + sizeof(input));
+    BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_characters_at_any_position) {
+  // Place runs of characters to escape at all positions and with all spacings
+  // within 16 byte chunks, and compare the SSE output with the scalar one.
+  const std::string special = "\"\\\n\x01\x1F";
+  for (auto spacing = 1; spacing < 20; spacing++) {
+    for (auto offset = 0; offset < 20; offset++) {
+      std::string input(offset, 'x');
+      for (auto i = 0; i < 100; i++) {
+        input += (i % spacing == 0) ? special[i % special.size()] : char('a' + i % 26);
+      }
+      BOOST_REQUIRE_EQUAL(escaped(true, input), escaped(false, input));
+    }
+  }
+
+  std::string all_quotes_answer;
+  for (auto i = 0; i < 32; i++) {
+    all_quotes_answer += "\\\"";
+  }
+  BOOST_CHECK_EQUAL(escaped(true, std::string(32, '"')), all_quotes_answer);
+}
+
+bool write_escaped_utf8(const bool use_sse, const std::string &input) {
+  encode_context context;
+  *const_cast<bool *>(&context.has_sse42) &= use_sse;
+  context.validate_utf8 = true;
+  try {
+    write_escaped(context, input.data(), input.data() + input.size());
+    BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), input);
+    return true;
+  } catch (const encode_exception &) {
+    return false;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_validate_utf8) {
+  for (const auto use_sse : { true, false }) {
+    for (auto n = 0; n < 64; n++) {
+      std::string utf8(n % 16, 'x');
+      for (auto i = 0; i < n; i++) {
+        utf8 += (i % 2 ? "\xF0\x9F\x98\x80" : "\xE2\x82\xAC");
+      }
+      BOOST_CHECK(write_escaped_utf8(use_sse, utf8));
+      BOOST_CHECK(!write_escaped_utf8(use_sse, utf8 + "\xE2\x82"));
+      BOOST_CHECK(!write_escaped_utf8(use_sse, utf8 + "\xED\xA0\x80" + utf8));
+      BOOST_CHECK(!write_escaped_utf8(use_sse, utf8 + "\xC0\x80" + utf8));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_while_validating_utf8) {
+  for (const auto use_sse : { true, false }) {
+    encode_context context;
+    *const_cast<bool *>(&context.has_sse42) &= use_sse;
+    context.validate_utf8 = true;
+    const std::string input = "\xE2\x82\xAC\"\n0123456789abcdef\x01\xC3\xA9\\";
+    write_escaped(context, input.data(), input.data() + input.size());
+    BOOST_CHECK_EQUAL(
+        std::string(context.data(), context.size()),
+        "\xE2\x82\xAC\\\"\\n0123456789abcdef\\u0001\xC3\xA9\\\\");
+  }
+}
+
 BOOST_AUTO_TEST_CASE(json_write_escaped_should_escape_zero_sized_nullptr) {
   encode_context context;
   write_escaped(context, nullptr, 0);
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/field_profile.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+struct profiled_track_t {
+  std::string title;
+  int length = 0;
+};
+
+struct profiled_playlist_t {
+  std::string name;
+  std::vector<profiled_track_t> tracks;
+};
+
+codec::object_t<profiled_playlist_t> profiled_playlist_codec() {
+  auto track_codec = codec::object<profiled_track_t>();
+  track_codec.required("title", &profiled_track_t::title);
+  track_codec.optional("length", &profiled_track_t::length);
+
+  auto codec = codec::object<profiled_playlist_t>();
+  codec.required("name", &profiled_playlist_t::name);
+  codec.required("tracks", &profiled_playlist_t::tracks, codec::array<std::vector<profiled_track_t>>(track_codec));
+  return codec;
+}
+
+const char *PROFILED_PLAYLIST_JSON =
+    R"({"name":"abc","tracks":[{"title":"a","length":1},{"title":"bc"}]})";
+
+/**
+ * Profiles the function, and returns the entries that it recorded.
+ */
+template <typename function>
+std::vector<field_profile_entry> profile(const function &fn) {
+  reset_field_profile();
+  set_field_profiling(true);
+  fn();
+  set_field_profiling(false);
+  return read_field_profile();
+}
+
+const field_profile_entry *find_entry(const std::vector<field_profile_entry> &entries, const std::string &path) {
+  for (const auto &entry : entries) {
+    if (entry.path == path) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_record_decoded_fields_by_path) {
+  const auto codec = profiled_playlist_codec();
+  const auto entries = profile([&] { decode(codec, PROFILED_PLAYLIST_JSON); });
+
+  BOOST_REQUIRE_EQUAL(entries.size(), 4);
+  BOOST_CHECK_EQUAL(entries[0].path, "name");
+  BOOST_CHECK_EQUAL(entries[1].path, "tracks");
+  BOOST_CHECK_EQUAL(entries[2].path, "tracks.length");
+  BOOST_CHECK_EQUAL(entries[3].path, "tracks.title");
+
+  BOOST_CHECK_EQUAL(entries[0].decode.calls, 1);
+  BOOST_CHECK_EQUAL(entries[0].decode.bytes, 5);
+  BOOST_CHECK_EQUAL(entries[1].decode.calls, 1);
+  BOOST_CHECK_EQUAL(entries[1].decode.bytes, 41);
+  BOOST_CHECK_EQUAL(entries[2].decode.calls, 1);
+  BOOST_CHECK_EQUAL(entries[2].decode.bytes, 1);
+  BOOST_CHECK_EQUAL(entries[3].decode.calls, 2);
+  BOOST_CHECK_EQUAL(entries[3].decode.bytes, 3 + 4);
+  BOOST_CHECK_EQUAL(entries[3].encode.calls, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_separate_self_time_from_nested_fields) {
+  const auto codec = profiled_playlist_codec();
+  const auto entries = profile([&] {
+    for (int i = 0; i < 100; i++) {
+      decode(codec, PROFILED_PLAYLIST_JSON);
+    }
+  });
+
+  const auto tracks = find_entry(entries, "tracks");
+  const auto title = find_entry(entries, "tracks.title");
+  const auto length = find_entry(entries, "tracks.length");
+  BOOST_REQUIRE(tracks && title && length);
+  BOOST_CHECK_LE(tracks->decode.self_nanoseconds, tracks->decode.nanoseconds);
+  BOOST_CHECK_GE(tracks->decode.nanoseconds, title->decode.nanoseconds + length->decode.nanoseconds);
+  BOOST_CHECK_EQUAL(
+      tracks->decode.nanoseconds - tracks->decode.self_nanoseconds,
+      title->decode.nanoseconds + length->decode.nanoseconds);
+  BOOST_CHECK_EQUAL(title->decode.nanoseconds, title->decode.self_nanoseconds);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_record_encoded_fields) {
+  const auto codec = profiled_playlist_codec();
+  const auto playlist = decode(codec, PROFILED_PLAYLIST_JSON);
+  const auto entries = profile([&] { encode(codec, playlist); });
+
+  const auto name = find_entry(entries, "name");
+  const auto title = find_entry(entries, "tracks.title");
+  BOOST_REQUIRE(name && title);
+  BOOST_CHECK_EQUAL(name->encode.calls, 1);
+  BOOST_CHECK_EQUAL(name->encode.bytes, std::string(R"("name":"abc",)").size());
+  BOOST_CHECK_EQUAL(title->encode.calls, 2);
+  BOOST_CHECK_EQUAL(name->decode.calls, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_record_nothing_when_disabled) {
+  const auto codec = profiled_playlist_codec();
+  reset_field_profile();
+  encode(codec, decode(codec, PROFILED_PLAYLIST_JSON));
+  BOOST_CHECK(read_field_profile().empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_sum_up_threads) {
+  const auto codec = profiled_playlist_codec();
+  const auto entries = profile([&] {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([&] {
+        for (int j = 0; j < 10; j++) {
+          decode(codec, PROFILED_PLAYLIST_JSON);
+        }
+      });
+    }
+    decode(codec, PROFILED_PLAYLIST_JSON);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  });
+
+  BOOST_REQUIRE_EQUAL(entries.size(), 4);
+  BOOST_CHECK_EQUAL(find_entry(entries, "name")->decode.calls, 41);
+  BOOST_CHECK_EQUAL(find_entry(entries, "tracks.title")->decode.calls, 82);
+  BOOST_CHECK_EQUAL(find_entry(entries, "tracks.title")->decode.bytes, 41 * 7);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_reset_fields_of_all_threads) {
+  const auto codec = profiled_playlist_codec();
+  set_field_profiling(true);
+  std::thread([&] { decode(codec, PROFILED_PLAYLIST_JSON); }).join();
+  decode(codec, PROFILED_PLAYLIST_JSON);
+  set_field_profiling(false);
+  reset_field_profile();
+  BOOST_CHECK(read_field_profile().empty());
+
+  const auto entries = profile([&] { decode(codec, PROFILED_PLAYLIST_JSON); });
+  BOOST_CHECK_EQUAL(find_entry(entries, "tracks.title")->decode.calls, 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_restore_the_path_after_failures) {
+  const auto codec = profiled_playlist_codec();
+  const auto entries = profile([&] {
+    BOOST_CHECK_THROW(decode(codec, R"({"tracks":[{"title":1}]})"), decode_exception);
+    decode(codec, PROFILED_PLAYLIST_JSON);
+  });
+
+  BOOST_CHECK_EQUAL(entries.size(), 4);
+  BOOST_CHECK(find_entry(entries, "name"));
+  BOOST_CHECK_EQUAL(find_entry(entries, "tracks")->decode.calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_field_profile_should_dump_a_table) {
+  const auto codec = profiled_playlist_codec();
+  profile([&] { decode(codec, PROFILED_PLAYLIST_JSON); });
+
+  std::ostringstream stream;
+  dump_field_profile(stream);
+  const auto dump = stream.str();
+  BOOST_CHECK_EQUAL(dump.compare(0, 6, "decode"), 0);
+  BOOST_CHECK_NE(dump.find("tracks.title\n"), std::string::npos);
+  BOOST_CHECK_EQUAL(dump.find("encode"), std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
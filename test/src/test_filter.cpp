@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/filter.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct item_t {
+  std::string status;
+  int price = 0;
+};
+
+object_t<item_t> item_codec() {
+  auto codec = object<item_t>();
+  codec.required("status", &item_t::status);
+  codec.required("price", &item_t::price);
+  return codec;
+}
+
+auto is_active() {
+  return where("status", string(), [](const std::string &status) { return status == "active"; });
+}
+
+auto is_expensive() {
+  return where("price", number<int>(), [](const int price) { return price >= 10; });
+}
+
+const std::string items_json = R"([
+  {"status":"active","price":5},
+  {"price":20,"status":"inactive"},
+  {"status":"active","price":15,"tags":["a"]},
+  {"price":30,"extra":{"status":"inactive"},"status":"active"},
+  {"price":40}
+])";
+
+template <typename Codec>
+typename Codec::object_type test_decode(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  auto obj = codec.decode(c);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  return obj;
+}
+
+template <typename Codec>
+void test_decode_fail(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  BOOST_CHECK_THROW(codec.decode(c), decode_exception);
+}
+
+}  // namespace
+
+/*
+ * filtered_array_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_filtered_array_should_decode_matching_elements) {
+  const auto codec = filtered_array<std::vector<item_t>>(item_codec(), is_active(), is_expensive());
+  const auto items = test_decode(codec, items_json);
+  BOOST_REQUIRE_EQUAL(items.size(), 2);
+  BOOST_CHECK_EQUAL(items[0].price, 15);
+  BOOST_CHECK_EQUAL(items[1].price, 30);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_filtered_array_should_not_decode_fields_of_rejected_elements) {
+  const auto codec = filtered_array<std::vector<item_t>>(item_codec(), is_active(), is_expensive());
+  const auto items = test_decode(codec, R"([{"status":"inactive","price":"not a number"},{"price":5,"status":"active"}])");
+  BOOST_CHECK(items.empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_filtered_array_should_decode_all_elements_without_predicates) {
+  const auto codec = filtered_array<std::vector<int>>(object<int>());
+  BOOST_CHECK_EQUAL(test_decode(codec, "[{},{\"a\":1}]").size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_filtered_array_should_not_decode_invalid_arrays) {
+  const auto codec = filtered_array<std::vector<item_t>>(item_codec(), is_active());
+  test_decode_fail(codec, "[1]");
+  test_decode_fail(codec, "[{\"status\":1}]");
+  test_decode_fail(codec, "[{\"status\":\"active\"}]");  // matches, but price is required
+  test_decode_fail(codec, "[{\"status\":\"inactive\",}]");
+  test_decode_fail(codec, "{}");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_filtered_array_should_encode_all_elements) {
+  const auto codec = filtered_array<std::vector<item_t>>(item_codec(), is_active());
+  const auto json = encode(codec, std::vector<item_t>{ { "active", 1 }, { "inactive", 2 } });
+  BOOST_CHECK_EQUAL(json, R"([{"status":"active","price":1},{"status":"inactive","price":2}])");
+}
+
+/*
+ * count_array_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_count_array_should_count_matching_elements) {
+  BOOST_CHECK_EQUAL(test_decode(count_array(), items_json), 5);
+  BOOST_CHECK_EQUAL(test_decode(count_array(is_active()), items_json), 3);
+  BOOST_CHECK_EQUAL(test_decode(count_array(is_expensive(), is_active()), items_json), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_count_array_should_not_encode) {
+  BOOST_CHECK_THROW(encode(count_array(), size_t(1)), encode_exception);
+}
+
+/*
+ * fold_array_t
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_fold_array_should_sum_matching_elements) {
+  BOOST_CHECK_EQUAL(test_decode(sum_array<int>("price"), items_json), 110);
+  BOOST_CHECK_EQUAL(test_decode(sum_array<int>("price", is_active()), items_json), 50);
+  test_decode_fail(sum_array<int>("price"), R"([{"price":"not a number"}])");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_fold_array_should_fold_field) {
+  const auto codec = fold_array(
+      std::vector<std::string>(),
+      "status",
+      string(),
+      [](std::vector<std::string> &statuses, std::string status) {
+        statuses.push_back(std::move(status));
+      },
+      is_expensive());
+  const auto statuses = test_decode(codec, items_json);
+  BOOST_CHECK((statuses == std::vector<std::string>{ "inactive", "active", "active" }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/frozen.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/optional.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct frozen_track_t {
+  std::string title;
+  int length = 0;
+};
+
+object_t<frozen_track_t> frozen_track_codec() {
+  auto codec = object<frozen_track_t>();
+  codec.required("title", &frozen_track_t::title);
+  codec.optional("length", &frozen_track_t::length);
+  return codec;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_should_not_be_copyable) {
+  using frozen_type = frozen_t<object_t<frozen_track_t>>;
+  BOOST_CHECK(!std::is_copy_constructible<frozen_type>::value);
+  BOOST_CHECK(std::is_nothrow_move_constructible<frozen_type>::value);
+  BOOST_CHECK(std::is_trivially_copyable<frozen_ref_t<object_t<frozen_track_t>>>::value);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_should_decode_and_encode) {
+  const auto codec = freeze(frozen_track_codec());
+  const auto track = decode(codec, R"({"title":"a","length":3})");
+  BOOST_CHECK_EQUAL(track.title, "a");
+  BOOST_CHECK_EQUAL(track.length, 3);
+  BOOST_CHECK_EQUAL(encode(codec, track), R"({"title":"a","length":3})");
+  BOOST_CHECK_THROW(decode(codec, R"({"length":3})"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_ref_should_decode_and_encode) {
+  const auto frozen = freeze(frozen_track_codec());
+  const auto codec = frozen.ref();
+  BOOST_CHECK(&codec.codec() == &frozen.codec());
+  const auto track = decode(codec, R"({"title":"b"})");
+  BOOST_CHECK_EQUAL(track.title, "b");
+  BOOST_CHECK_EQUAL(encode(codec, track), R"({"title":"b","length":0})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_ref_should_stay_valid_when_frozen_is_moved) {
+  auto frozen = freeze(frozen_track_codec());
+  const auto codec = frozen.ref();
+  const auto moved = std::move(frozen);
+  BOOST_CHECK(&codec.codec() == &moved.codec());
+  BOOST_CHECK_EQUAL(decode(codec, R"({"title":"c"})").title, "c");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_ref_should_compose_with_other_codecs) {
+  const auto frozen = freeze(frozen_track_codec());
+  const auto codec = array<std::vector<frozen_track_t>>(frozen.ref());
+  const auto tracks = decode(codec, R"([{"title":"a"},{"title":"b","length":2}])");
+  BOOST_REQUIRE_EQUAL(tracks.size(), 2);
+  BOOST_CHECK_EQUAL(tracks[1].length, 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_should_forward_decode_into) {
+  const auto frozen = freeze(frozen_track_codec());
+  auto track = frozen_track_t{ "a", 7 };
+  decode_into(frozen.ref(), R"({"title":"b"})", track);
+  BOOST_CHECK_EQUAL(track.title, "b");
+  BOOST_CHECK_EQUAL(track.length, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_should_forward_should_encode_and_accepted_tokens) {
+  const auto frozen = freeze(optional(number<int>()));
+  BOOST_CHECK(!frozen.should_encode(std::optional<int>()));
+  BOOST_CHECK(frozen.ref().should_encode(std::optional<int>(1)));
+  BOOST_CHECK_EQUAL(freeze(string()).accepted_tokens(), detail::accepted_tokens(string()));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_frozen_should_be_shared_between_threads) {
+  const auto frozen = freeze(frozen_track_codec());
+  std::vector<std::thread> threads;
+  std::vector<int> lengths(4);
+  for (size_t i = 0; i < lengths.size(); i++) {
+    threads.emplace_back([&frozen, &lengths, i] {
+      const auto json = R"({"title":"t","length":)" + std::to_string(i) + "}";
+      for (int n = 0; n < 1000; n++) {
+        lengths[i] += decode(frozen.ref(), json).length;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < lengths.size(); i++) {
+    BOOST_CHECK_EQUAL(lengths[i], 1000 * int(i));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
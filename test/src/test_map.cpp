@@ -14,13 +14,16 @@
  * the License.
  */
 
+#include <map>
 #include <string>
+#include <unordered_map>
 
 #include <boost/test/unit_test.hpp>
 
 #include <spotify/json/codec/any_value.hpp>
 #include <spotify/json/codec/map.hpp>
 #include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/number.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/encode.hpp>
 
@@ -92,6 +95,41 @@ BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_encoded_value_element) {
   BOOST_CHECK(map_parse<encoded_value>(R"({"a":true})") == map);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_first_of_duplicate_keys) {
+  const auto map = decode<std::map<std::string, int>>(R"({"a":1,"b":2,"a":3})");
+  BOOST_CHECK((map == std::map<std::string, int>{ { "a", 1 }, { "b", 2 } }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_unordered_map) {
+  const auto map = decode<std::unordered_map<std::string, int>>(R"({"b":2,"a":1,"b":3})");
+  BOOST_CHECK((map == std::unordered_map<std::string, int>{ { "a", 1 }, { "b", 2 } }));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_large_unordered_map) {
+  std::string json = "{";
+  std::unordered_map<std::string, int> expected;
+  for (int i = 0; i < 1000; i++) {
+    json += (i ? ",\"" : "\"") + std::to_string(i) + "\":" + std::to_string(i);
+    expected[std::to_string(i)] = i;
+  }
+  json += "}";
+  BOOST_CHECK((decode<std::unordered_map<std::string, int>>(json) == expected));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_into_map) {
+  std::map<std::string, std::string> map = { { "a", "old a" }, { "b", "old b" } };
+  const auto *a = &map["a"];
+  decode_into(R"({"c":"new c","a":"new a","a":"newer a"})", map);
+  BOOST_CHECK((map == std::map<std::string, std::string>{ { "a", "new a" }, { "c", "new c" } }));
+  BOOST_CHECK_EQUAL(&map["a"], a);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_map_should_decode_into_unordered_map) {
+  std::unordered_map<std::string, int> map = { { "a", 1 }, { "b", 2 } };
+  decode_into(R"({"b":3,"c":4})", map);
+  BOOST_CHECK((map == std::unordered_map<std::string, int>{ { "b", 3 }, { "c", 4 } }));
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_map_should_not_decode_otherwise) {
   map_parse_should_fail("");
   map_parse_should_fail("{");
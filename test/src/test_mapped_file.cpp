@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/any_value.hpp>
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/decode_file.hpp>
+#include <spotify/json/mapped_file.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * A file with the given contents in the temporary directory, which is removed
+ * again when the temporary_file is destroyed.
+ */
+struct temporary_file {
+  explicit temporary_file(const std::string &contents)
+      : path((std::filesystem::temp_directory_path() /
+              ("spotify_json_test_" + std::to_string(std::random_device()()))).string()) {
+    std::ofstream(path, std::ios::binary) << contents;
+  }
+
+  ~temporary_file() {
+    std::error_code error;
+    std::filesystem::remove(path, error);
+  }
+
+  const std::string path;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_map_the_file) {
+  const temporary_file file("[1,2,3]");
+  const mapped_file mapped(file.path);
+  BOOST_CHECK_EQUAL(std::string(mapped.data(), mapped.size()), "[1,2,3]");
+}
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_be_padded_with_zeros) {
+  const auto page_size = size_t(4096);
+  for (const auto size : { size_t(0), size_t(1), page_size - 16, page_size - 15, page_size - 1, page_size, page_size + 1 }) {
+    const temporary_file file(std::string(size, 'a'));
+    const mapped_file mapped(file.path);
+    BOOST_REQUIRE_EQUAL(mapped.size(), size);
+    for (size_t i = 0; i < padded_string_view::padding; i++) {
+      BOOST_CHECK_EQUAL(mapped.data()[size + i], '\0');
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_throw_when_the_file_is_missing) {
+  BOOST_CHECK_THROW(mapped_file("/nonexistent/spotify_json_test"), std::system_error);
+  BOOST_CHECK_THROW(decode_file<int>("/nonexistent/spotify_json_test"), std::system_error);
+}
+
+BOOST_AUTO_TEST_CASE(json_mapped_file_should_keep_the_mapping_when_moved) {
+  const temporary_file file("abc");
+  mapped_file mapped(file.path);
+  const auto data = mapped.data();
+  const auto moved = std::move(mapped);
+  BOOST_CHECK(moved.data() == data);
+  BOOST_CHECK(mapped.data() == nullptr);
+  BOOST_CHECK_EQUAL(mapped.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_decode) {
+  const temporary_file file(R"( {"a":[1,2],"b":[3]} )");
+  using map_type = std::map<std::string, std::vector<int>>;
+  const auto expected = map_type{ { "a", { 1, 2 } }, { "b", { 3 } } };
+  BOOST_CHECK(decode_file<map_type>(file.path) == expected);
+  BOOST_CHECK(decode_file(default_codec<map_type>(), file.path) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_decode_strings_that_end_at_the_end_of_a_page) {
+  for (const auto size : { size_t(4094), size_t(4095), size_t(4096), size_t(4097) }) {
+    const auto value = std::string(size - 2, 'x');
+    const temporary_file file("\"" + value + "\"");
+    BOOST_CHECK_EQUAL(decode_file<std::string>(file.path), value);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_file_should_fail_on_invalid_json) {
+  const temporary_file empty("");
+  const temporary_file invalid("[1,");
+  BOOST_CHECK_THROW(decode_file<int>(empty.path), decode_exception);
+  BOOST_CHECK_THROW(decode_file<std::vector<int>>(invalid.path), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_mapped_file_should_point_into_the_mapping) {
+  const temporary_file file(R"({"a":[1, 2]})");
+  auto decoded = decode_mapped_file(codec::any_value(), file.path);
+  const auto moved = std::move(decoded);
+  BOOST_CHECK(moved.value.data() == moved.file.data());
+  BOOST_CHECK_EQUAL(std::string(moved.value.data(), moved.value.size()), R"({"a":[1, 2]})");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -14,6 +14,7 @@
  * the License.
  */
 
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -95,6 +96,18 @@ codec::object_t<subclass_t> subclass_codec() {
   return codec;
 }
 
+struct passthrough_t {
+  std::string value;
+  unknown_fields unknown;
+};
+
+codec::object_t<passthrough_t> passthrough_codec() {
+  codec::object_t<passthrough_t> codec;
+  codec.optional("value", &passthrough_t::value);
+  codec.capture_unknown_fields(&passthrough_t::unknown);
+  return codec;
+}
+
 }  // namespace
 
 template <>
@@ -144,6 +157,85 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_overwrite_duplicate_fields) {
   BOOST_CHECK_EQUAL(example.value, "hey2");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_existing_object) {
+  example_t example;
+  example.simple.size = 1;
+  example.simple.value = "a value that does not fit in a small string";
+  example.value = "another value that does not fit in a small string";
+  const auto simple_data = example.simple.value.data();
+  const auto value_data = example.value.data();
+
+  decode_into(example_codec(), R"({"simple":{"value":"x"},"value":"y"})", example);
+  BOOST_CHECK_EQUAL(example.simple.size, 0);  // not in the input, so reset
+  BOOST_CHECK_EQUAL(example.simple.value, "x");
+  BOOST_CHECK_EQUAL(example.value, "y");
+  BOOST_CHECK_EQUAL(static_cast<const void *>(example.simple.value.data()), static_cast<const void *>(simple_data));
+  BOOST_CHECK_EQUAL(static_cast<const void *>(example.value.data()), static_cast<const void *>(value_data));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_like_decode) {
+  const auto codec = example_codec();
+  example_t example;
+  decode_into(codec, R"({"simple":{"size":3,"value":"a value that does not fit in a small string"},"value":"x"})", example);
+  const auto simple_data = example.simple.value.data();
+
+  decode_into(codec, R"({"simple":{"size":4},"value":"y"})", example);
+  BOOST_CHECK_EQUAL(example.simple.size, 4);
+  BOOST_CHECK_EQUAL(example.simple.value, "");
+  BOOST_CHECK_EQUAL(static_cast<const void *>(example.simple.value.data()), static_cast<const void *>(simple_data));
+
+  decode_into(codec, R"({"value":"z"})", example);
+  BOOST_CHECK_EQUAL(example.simple.size, 0);
+  BOOST_CHECK_EQUAL(example.value, "z");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_members_with_initializers_like_decode) {
+  struct settings_t {
+    bool enabled = true;
+    int retries = 3;
+    std::string name = "default";
+  };
+  auto codec = object<settings_t>();
+  codec.optional("enabled", &settings_t::enabled);
+  codec.optional("retries", &settings_t::retries);
+  codec.optional("name", &settings_t::name);
+
+  settings_t settings;
+  decode_into(codec, R"({"enabled":false,"retries":1,"name":"a name"})", settings);
+  BOOST_CHECK(!settings.enabled);
+  decode_into(codec, "{}", settings);
+  BOOST_CHECK(settings.enabled);
+  BOOST_CHECK_EQUAL(settings.retries, 3);
+  BOOST_CHECK_EQUAL(settings.name, "default");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_with_custom_creator_like_decode) {
+  auto codec = object([] {
+    example_t value;
+    value.value = "hello";
+    return value;
+  });
+  codec.optional("value", &example_t::value);
+
+  example_t example;
+  decode_into(codec, R"({"value":"x"})", example);
+  BOOST_CHECK_EQUAL(example.value, "x");
+  decode_into(codec, "{}", example);
+  BOOST_CHECK_EQUAL(example.value, decode(codec, "{}").value);
+  BOOST_CHECK_EQUAL(example.value, "hello");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_into_setter_field) {
+  getset_t getset;
+  decode_into(getset_codec(), R"({"value":"x"})", getset);
+  BOOST_CHECK_EQUAL(getset.get_value(), "x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_require_required_fields_when_decoding_into) {
+  example_t example;
+  BOOST_CHECK_THROW(decode_into(example_codec(), R"({"simple":{}})", example), decode_exception);
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_object_should_use_custom_creator_when_decoding) {
   object_t<example_t> codec([]{
     example_t value;
@@ -268,6 +360,117 @@ BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_lambda_getter_field) {
   BOOST_CHECK_EQUAL(encode(codec, getset), R"({"value":"foobar"})");
 }
 
+/*
+ * Projecting
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_decode_projected_fields) {
+  const auto codec = default_codec<simple_t>();
+  const std::string json = R"({"value":"hey","size":123456})";
+  decode_context c(json.data(), json.size());
+  const auto simple = codec.decode(c, codec.projection({ "size" }));
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  BOOST_CHECK_EQUAL(simple.size, 123456);
+  BOOST_CHECK_EQUAL(simple.value, "");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_skip_invalid_values_of_unprojected_fields) {
+  const auto codec = projected(example_codec(), { "value" });
+  const auto example = test_decode(codec, R"({"simple":{"size":"not a number"},"value":"x"})");
+  BOOST_CHECK_EQUAL(example.value, "x");
+  BOOST_CHECK_EQUAL(example.simple.size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_only_require_projected_required_fields) {
+  const auto example = test_decode(projected(example_codec(), { "simple" }), R"({"simple":{"size":1}})");
+  BOOST_CHECK_EQUAL(example.simple.size, 1);
+  test_decode_fail(projected(example_codec(), { "simple", "value" }), R"({"simple":{"size":1}})");
+  test_decode_fail(projected(example_codec(), { "value" }), R"({"simple":{"size":1}})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_count_duplicate_projected_names_once) {
+  test_decode(projected(example_codec(), { "value", "value" }), R"({"value":"x"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_project_unknown_fields) {
+  BOOST_CHECK_THROW(example_codec().projection({ "value", "unknown" }), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_use_projections_of_other_codecs) {
+  auto codec = example_codec();
+  const auto projection = codec.projection({ "value" });
+  const auto copy = codec;
+  encode_context copy_context;
+  copy.encode(copy_context, example_t(), projection);
+  BOOST_CHECK_EQUAL(std::string(copy_context.data(), copy_context.size()), R"({"value":""})");
+
+  const std::string json = R"({"value":"x"})";
+  auto other_context = decode_context(json.data(), json.size());
+  BOOST_CHECK_THROW(example_codec().decode(other_context, projection), std::invalid_argument);
+
+  codec.optional("other", &example_t::value);
+  auto context = decode_context(json.data(), json.size());
+  BOOST_CHECK_THROW(codec.decode(context, projection), std::invalid_argument);
+  encode_context encode_context;
+  BOOST_CHECK_THROW(codec.encode(encode_context, example_t(), projection), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_projected_fields) {
+  simple_t simple;
+  simple.value = "hey";
+  simple.size = 123456789;
+  const auto codec = default_codec<simple_t>();
+  encode_context context;
+  codec.encode(context, simple, codec.projection({ "value" }));
+  BOOST_CHECK_EQUAL(std::string(context.data(), context.size()), R"({"value":"hey"})");
+  BOOST_CHECK_EQUAL(encode(projected(codec, std::vector<std::string>()), simple), "{}");
+  BOOST_CHECK_EQUAL(encode(projected(codec, { "value", "size" }), simple), R"({"size":123456789,"value":"hey"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_capture_unknown_fields) {
+  const std::string json = R"({"a":[1, {"b":null}],"value":"x", "c\"d" : "e"})";
+  const auto passthrough = test_decode(passthrough_codec(), json);
+  BOOST_CHECK_EQUAL(passthrough.value, "x");
+  BOOST_REQUIRE_EQUAL(passthrough.unknown.size(), 2);
+  BOOST_CHECK_EQUAL(std::string(passthrough.unknown[0].key.data(), passthrough.unknown[0].key.size()), R"("a")");
+  BOOST_CHECK_EQUAL(
+      std::string(passthrough.unknown[0].value.data(), passthrough.unknown[0].value.size()),
+      R"([1, {"b":null}])");
+  BOOST_CHECK_EQUAL(std::string(passthrough.unknown[1].key.data(), passthrough.unknown[1].key.size()), R"("c\"d")");
+  BOOST_CHECK(passthrough.unknown[1].value.data() > json.data());
+  BOOST_CHECK(passthrough.unknown[1].value.data() < json.data() + json.size());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_encode_captured_unknown_fields) {
+  const auto codec = passthrough_codec();
+  const std::string json = R"({"a":[1, {"b":null}],"value":"x","c\"d":"e"})";
+  auto passthrough = test_decode(codec, json);
+  passthrough.value = "y";
+  BOOST_CHECK_EQUAL(encode(codec, passthrough), R"({"value":"y","a":[1, {"b":null}],"c\"d":"e"})");
+  BOOST_CHECK_EQUAL(encode(codec, passthrough_t()), R"({"value":""})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_replace_captured_unknown_fields_when_decoding_into) {
+  const auto codec = passthrough_codec();
+  const std::string first = R"({"a":1})";
+  const std::string second = R"({"b":2})";
+  passthrough_t passthrough;
+  decode_into(codec, first, passthrough);
+  decode_into(codec, second, passthrough);
+  BOOST_CHECK_EQUAL(encode(codec, passthrough), R"({"value":"","b":2})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_not_capture_unknown_fields_with_projection) {
+  const auto codec = passthrough_codec();
+  const auto passthrough = test_decode(projected(codec, { "value" }), R"({"a":1,"value":"x"})");
+  BOOST_CHECK(passthrough.unknown.empty());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_object_should_fail_on_invalid_unknown_fields) {
+  test_decode_fail(passthrough_codec(), R"({"a":[1,})");
+  test_decode_fail(passthrough_codec(), R"({"a":x})");
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
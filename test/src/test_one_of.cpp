@@ -19,6 +19,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/codec/eq.hpp>
 #include <spotify/json/codec/ignore.hpp>
 #include <spotify/json/codec/null.hpp>
 #include <spotify/json/codec/one_of.hpp>
@@ -51,6 +52,30 @@ struct example_t {
   std::string value;
 };
 
+/**
+ * String codec that counts how many times it has been asked to decode.
+ */
+struct counting_string_t {
+  using object_type = std::string;
+
+  explicit counting_string_t(size_t &num_decodes) : num_decodes(num_decodes) {}
+
+  object_type decode(decode_context &context) const {
+    num_decodes++;
+    return string().decode(context);
+  }
+
+  void encode(encode_context &context, const object_type &value) const {
+    string().encode(context, value);
+  }
+
+  detail::token_mask accepted_tokens() const {
+    return detail::token_string;
+  }
+
+  size_t &num_decodes;
+};
+
 }  // namespace
 
 /*
@@ -121,6 +146,43 @@ BOOST_AUTO_TEST_CASE(json_codec_one_of_ignore) {
   test_decode_fail(codec, "{");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_skip_codecs_that_do_not_accept_token) {
+  size_t num_decodes = 0;
+  const auto codec = one_of(counting_string_t(num_decodes), null<std::string>("null"));
+  BOOST_CHECK_EQUAL(test_decode(codec, "null"), "null");
+  BOOST_CHECK_EQUAL(num_decodes, 0);
+  BOOST_CHECK_EQUAL(test_decode(codec, "\"abc\""), "abc");
+  BOOST_CHECK_EQUAL(num_decodes, 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_backtrack_when_ambiguous) {
+  const auto codec = one_of(eq(std::string("a")), string(), null<std::string>());
+  BOOST_CHECK_EQUAL(test_decode(codec, "\"a\""), "a");
+  BOOST_CHECK_EQUAL(test_decode(codec, "\"b\""), "b");
+  BOOST_CHECK_EQUAL(test_decode(codec, "null"), "");
+  test_decode_fail(codec, "true");
+  test_decode_fail(codec, "");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_fail_with_error_from_last_codec) {
+  const auto codec = one_of(string(), null<std::string>());
+  try {
+    decode(codec, "true");
+    BOOST_FAIL("decode should have failed");
+  } catch (const decode_exception &exception) {
+    BOOST_CHECK_EQUAL(exception.what(), "Unexpected input");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_one_of_should_have_union_of_accepted_tokens) {
+  BOOST_CHECK_EQUAL(
+      one_of(string(), null<std::string>()).accepted_tokens(),
+      detail::token_string | detail::token_null);
+  BOOST_CHECK_EQUAL(
+      one_of(string(), ignore<std::string>()).accepted_tokens(),
+      detail::token_any);
+}
+
 /*
  * Encoding
  */
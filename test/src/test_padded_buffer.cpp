@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/map.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/padded_buffer.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * A padded copy of the string whose padding is filled with the given byte,
+ * chosen so that the scanner under test would stop at it if it looked past
+ * the end of the input.
+ */
+padded_buffer make_padded(const std::string &string, const char padding) {
+  padded_buffer buffer(string);
+  std::memset(buffer.data() + buffer.size(), padding, padded_string_view::padding);
+  return buffer;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_copy_and_zero_the_padding) {
+  const padded_buffer buffer(std::string("abc"));
+  BOOST_CHECK_EQUAL(buffer.size(), 3);
+  BOOST_CHECK_EQUAL(std::string(buffer.data(), 3), "abc");
+  for (size_t i = 0; i < padded_string_view::padding; i++) {
+    BOOST_CHECK_EQUAL(buffer.data()[3 + i], '\0');
+  }
+
+  const padded_string_view view = buffer;
+  BOOST_CHECK(view.data() == buffer.data());
+  BOOST_CHECK_EQUAL(view.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_make_a_padded_decode_context) {
+  const padded_buffer buffer(std::string("1"));
+  BOOST_CHECK(decode_context(padded_string_view(buffer)).padded);
+  BOOST_CHECK(!decode_context(buffer.data(), buffer.size()).padded);
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_skip_simple_characters_up_to_end) {
+  for (size_t n = 0; n < 80; n++) {
+    for (const auto prefix : { size_t(0), size_t(1), size_t(7) }) {
+      const auto buffer = make_padded(std::string(prefix + n, 'a'), '"');
+      decode_context context(static_cast<padded_string_view>(buffer));
+      context.position += prefix;
+      detail::skip_any_simple_characters(context);
+      BOOST_CHECK_EQUAL(context.position - context.begin, prefix + n);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_stop_at_quotes_and_backslashes) {
+  for (size_t n = 0; n < 40; n++) {
+    for (const auto stop : { '"', '\\' }) {
+      const auto buffer = make_padded(std::string(n, 'a') + stop + "abc", '"');
+      decode_context context(static_cast<padded_string_view>(buffer));
+      detail::skip_any_simple_characters(context);
+      BOOST_CHECK_EQUAL(context.position - context.begin, n);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_copy_simple_characters_up_to_end) {
+  for (size_t n = 0; n < 80; n++) {
+    const auto string = std::string(n, 'b');
+    for (const auto &suffix : { std::string(), std::string("\"x") }) {
+      const auto buffer = make_padded(string + suffix, '"');
+      decode_context context(static_cast<padded_string_view>(buffer));
+      std::vector<char> out(n + 16);
+      auto dst = out.data();
+      detail::copy_any_simple_characters(context, dst);
+      BOOST_CHECK_EQUAL(context.position - context.begin, n);
+      BOOST_CHECK_EQUAL(std::string(out.data(), dst), string);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_skip_whitespace_up_to_end) {
+  for (size_t n = 0; n < 80; n++) {
+    const auto whitespace = std::string(n, ' ') + (n % 3 ? "\t\n\r" : "");
+    for (const auto &suffix : { std::string(), std::string("1 ") }) {
+      const auto buffer = make_padded(whitespace + suffix, ' ');
+      decode_context context(static_cast<padded_string_view>(buffer));
+      detail::skip_any_whitespace(context);
+      BOOST_CHECK_EQUAL(context.position - context.begin, whitespace.size());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_decode_like_unpadded_input) {
+  const auto codec = codec::map<std::map<std::string, std::vector<std::string>>>(
+      codec::array<std::vector<std::string>>(codec::string()));
+  for (size_t n = 0; n < 40; n++) {
+    const auto value = std::string(n, 'x');
+    const auto json = " {\"" + value + "\":[\"" + value + "\",\"\\n" + value + "\"]} " + std::string(n % 17, ' ');
+    const auto buffer = make_padded(json, '"');
+    BOOST_CHECK(decode(codec, buffer) == decode(codec, json));
+    BOOST_CHECK(decode(codec, padded_string_view(buffer)) == decode(codec, json));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_decode_strings_that_end_at_end) {
+  for (size_t n = 0; n < 40; n++) {
+    const auto value = std::string(n, 'y');
+    BOOST_CHECK_EQUAL(decode<std::string>(make_padded("\"" + value + "\"", '"')), value);
+    BOOST_CHECK_EQUAL(decode<std::string>(make_padded("\"\\t" + value + "\"", '"')), "\t" + value);
+    BOOST_CHECK_THROW(decode<std::string>(make_padded("\"" + value, '"')), decode_exception);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_padded_buffer_should_decode_into) {
+  int value = 0;
+  decode_into(codec::number<int>(), padded_buffer(std::string(" 17 ")), value);
+  BOOST_CHECK_EQUAL(value, 17);
+  BOOST_CHECK(try_decode(value, padded_buffer(std::string("18"))));
+  BOOST_CHECK_EQUAL(value, 18);
+  BOOST_CHECK(!try_decode(value, padded_buffer(std::string("x"))));
+  BOOST_CHECK(!try_decode(value, padded_buffer()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
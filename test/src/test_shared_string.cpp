@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/shared_string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/padded_buffer.hpp>
+#include <spotify/json/shared_string.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct shared_track_t {
+  shared_string id;
+  shared_string title;
+  int length = 0;
+};
+
+object_t<shared_track_t> shared_track_codec() {
+  auto codec = object<shared_track_t>();
+  codec.required("id", &shared_track_t::id);
+  codec.required("title", &shared_track_t::title);
+  codec.optional("length", &shared_track_t::length);
+  return codec;
+}
+
+bool points_into(const shared_string &string, const std::string &input) {
+  return string.data() >= input.data() && string.data() + string.size() <= input.data() + input.size();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_shared_string_should_compare_and_convert) {
+  const auto string = shared_string(std::string("abc"));
+  BOOST_CHECK_EQUAL(string, "abc");
+  BOOST_CHECK(string != shared_string(std::string("abd")));
+  BOOST_CHECK(string < shared_string(std::string("abd")));
+  BOOST_CHECK_EQUAL(string.str(), "abc");
+  BOOST_CHECK_EQUAL(std::string_view(string), "abc");
+  BOOST_CHECK(shared_string().empty());
+  BOOST_CHECK_EQUAL(shared_string(), "");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_point_into_shared_input) {
+  const auto input = std::make_shared<const std::string>(R"({"id":"t1","title":"A song","length":3})");
+  const auto track = decode_shared(shared_track_codec(), input);
+  BOOST_CHECK_EQUAL(track.id, "t1");
+  BOOST_CHECK_EQUAL(track.title, "A song");
+  BOOST_CHECK_EQUAL(track.length, 3);
+  BOOST_CHECK(points_into(track.id, *input));
+  BOOST_CHECK(points_into(track.title, *input));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_keep_input_alive) {
+  auto input = std::make_shared<const std::string>(R"(["a string that does not fit in a small string"])");
+  const std::weak_ptr<const std::string> weak_input = input;
+  auto strings = decode_shared<std::vector<shared_string>>(std::move(input));
+  BOOST_CHECK(!weak_input.expired());
+  BOOST_CHECK_EQUAL(strings[0], "a string that does not fit in a small string");
+  strings.clear();
+  BOOST_CHECK(weak_input.expired());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_copy_escaped_strings) {
+  const auto input = std::make_shared<const std::string>(R"(["a\nb","cd"])");
+  const auto strings = decode_shared<std::vector<shared_string>>(input);
+  BOOST_REQUIRE_EQUAL(strings.size(), 2);
+  BOOST_CHECK_EQUAL(strings[0], "a\nb");
+  BOOST_CHECK_EQUAL(strings[1], "cd");
+  BOOST_CHECK(!points_into(strings[0], *input));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_decode_padded_input) {
+  const auto input = std::make_shared<const padded_buffer>(std::string(R"(["a","b"])"));
+  const auto strings = decode_shared<std::vector<shared_string>>(input);
+  BOOST_REQUIRE_EQUAL(strings.size(), 2);
+  BOOST_CHECK_EQUAL(strings[1], "b");
+  BOOST_CHECK(strings[1].data() > input->data() && strings[1].data() < input->data() + input->size());
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_take_ownership_of_strings) {
+  const auto track = decode_shared(shared_track_codec(), std::string(R"({"id":"t2","title":"B"})"));
+  BOOST_CHECK_EQUAL(track.id, "t2");
+  BOOST_CHECK_EQUAL(track.title, "B");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_copy_without_shared_input) {
+  const std::string json = R"({"id":"t3","title":"C\"D"})";
+  const auto track = decode(shared_track_codec(), json);
+  BOOST_CHECK_EQUAL(track.id, "t3");
+  BOOST_CHECK_EQUAL(track.title, "C\"D");
+  BOOST_CHECK(!points_into(track.id, json));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_not_decode_invalid_strings) {
+  BOOST_CHECK_THROW(decode_shared<shared_string>(std::string(R"("abc)")), decode_exception);
+  BOOST_CHECK_THROW(decode_shared<shared_string>(std::string(R"("a\x")")), decode_exception);
+  BOOST_CHECK_THROW(decode_shared<shared_string>(std::string("1")), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_shared_string_should_encode) {
+  BOOST_CHECK_EQUAL(encode(shared_string(std::string("a\"b"))), R"("a\"b")");
+  BOOST_CHECK_EQUAL(
+      encode(shared_track_codec(), shared_track_t{ shared_string(std::string("t")), shared_string(), 1 }),
+      R"({"id":"t","title":"","length":1})");
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
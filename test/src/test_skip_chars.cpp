@@ -14,11 +14,14 @@
  * the License.
  */
 
+#include <cstdint>
 #include <cstdlib>
+#include <string>
 
 #include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <spotify/json/decode_exception.hpp>
 #include <spotify/json/detail/skip_chars.hpp>
 
 BOOST_AUTO_TEST_SUITE(spotify)
@@ -63,6 +66,66 @@ void verify_skip_empty_nullptr(const bool use_sse) {
   BOOST_CHECK(context.end == nullptr);
 }
 
+/**
+ * Strings of whole UTF-8 sequences of all lengths, shifted by the prefix so
+ * that sequences end up at every offset within a 16 byte chunk.
+ */
+std::string generate_utf8(const std::size_t prefix, const std::size_t count) {
+  static const char *sequences[] = { "a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xEF\xBF\xBF", "\xF4\x8F\xBF\xBF" };
+  std::string utf8(prefix, 'x');
+  for (std::size_t i = 0; i < count; i++) {
+    utf8 += sequences[i % 6];
+  }
+  return utf8;
+}
+
+const char *invalid_utf8[] = {
+  "\x80",              // continuation byte without lead byte
+  "\xBF\xBF",          // two continuation bytes
+  "\xC0\x80",          // overlong two byte sequence
+  "\xC1\xBF",          // overlong two byte sequence
+  "\xC3",              // two byte sequence cut short by the end
+  "\xC3\"",            // two byte sequence cut short by a quote
+  "\xC3\\\\",          // two byte sequence cut short by a backslash
+  "\xC3\xA9\xA9",      // too many continuation bytes
+  "\xE0\x80\x80",      // overlong three byte sequence
+  "\xE0\x9F\xBF",      // overlong three byte sequence
+  "\xED\xA0\x80",      // surrogate
+  "\xED\xBF\xBF",      // surrogate
+  "\xE2\x82",          // three byte sequence cut short by the end
+  "\xE2\x82" "a",      // three byte sequence cut short by ASCII
+  "\xF0\x80\x80\x80",  // overlong four byte sequence
+  "\xF0\x8F\xBF\xBF",  // overlong four byte sequence
+  "\xF4\x90\x80\x80",  // above U+10FFFF
+  "\xF5\x80\x80\x80",  // above U+10FFFF
+  "\xF0\x9F\x98",      // four byte sequence cut short by the end
+  "\xF8\x80\x80\x80\x80",  // five byte sequence
+  "\xFE",
+  "\xFF",
+};
+
+template <bool use_sse>
+void verify_skip_utf8(const std::string &json, const std::size_t suffix = 0) {
+  auto context = decode_context(json.data(), json.data() + json.size());
+  *const_cast<bool *>(&context.has_sse42) &= use_sse;
+  context.validate_utf8 = true;
+  skip_any_simple_characters(context);
+  BOOST_CHECK_EQUAL(context.end - context.position, suffix);
+}
+
+template <bool use_sse>
+bool is_valid_utf8(const std::string &json) {
+  auto context = decode_context(json.data(), json.data() + json.size());
+  *const_cast<bool *>(&context.has_sse42) &= use_sse;
+  context.validate_utf8 = true;
+  try {
+    skip_any_simple_characters(context);
+    return true;
+  } catch (const decode_exception &) {
+    return false;
+  }
+}
+
 using true_false = boost::mpl::list<boost::true_type, boost::false_type>;
 
 }  // namespace
@@ -98,6 +161,57 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters_with_empty_string,
   verify_skip_empty_nullptr<skip_any_simple_characters>(use_sse::value);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters_should_validate_utf8,
+                              use_sse,
+                              true_false) {
+  for (auto prefix = 0; prefix < 16; prefix++) {
+    for (auto n = 0; n < 64; n++) {
+      const auto utf8 = generate_utf8(prefix, n);
+      verify_skip_utf8<use_sse::value>(utf8);
+      verify_skip_utf8<use_sse::value>(utf8 + "\"abc", 4);
+      verify_skip_utf8<use_sse::value>(utf8 + "\\n", 2);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters_should_not_validate_utf8_after_quote,
+                              use_sse,
+                              true_false) {
+  verify_skip_utf8<use_sse::value>("abc\"\xFF\xFF", 3);
+  verify_skip_utf8<use_sse::value>(generate_utf8(0, 20) + "\"\xFF" + std::string(32, '\x80'), 34);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(json_skip_any_simple_characters_should_reject_invalid_utf8,
+                              use_sse,
+                              true_false) {
+  for (const auto invalid : invalid_utf8) {
+    for (auto prefix = 0; prefix < 34; prefix++) {
+      const auto json = generate_utf8(prefix, prefix % 7) + invalid;
+      BOOST_CHECK_MESSAGE(!is_valid_utf8<use_sse::value>(json), json);
+      BOOST_CHECK_MESSAGE(!is_valid_utf8<use_sse::value>(json + std::string(prefix, 'y')), json);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_skip_any_simple_characters_should_validate_utf8_like_scalar) {
+  // Compare the SSE implementation with the scalar one on pseudo random byte
+  // strings that are biased towards bytes that appear in UTF-8 sequences.
+  static const unsigned char bytes[] = {
+    'a', 'b', 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0, 0xC2, 0xDF,
+    0xE0, 0xE1, 0xED, 0xEF, 0xF0, 0xF1, 0xF4, 0xF5, 0xFF
+  };
+  uint32_t seed = 1;
+  for (auto i = 0; i < 20000; i++) {
+    std::string json;
+    const auto size = i % 40;
+    for (auto j = 0; j < size; j++) {
+      seed = seed * 1103515245 + 12345;
+      json += char(bytes[(seed >> 16) % sizeof(bytes)]);
+    }
+    BOOST_REQUIRE_EQUAL(is_valid_utf8<true>(json), is_valid_utf8<false>(json));
+  }
+}
+
 /*
  * skip_any_whitespace
  */
@@ -142,6 +142,54 @@ BOOST_AUTO_TEST_CASE(json_skip_value_should_not_skip_invalid_array) {
   verify_skip_fail("[12");
 }
 
+BOOST_AUTO_TEST_CASE(json_count_array_elements) {
+  const auto count = [](const std::string &json) {
+    const auto context = decode_context(json.data(), json.data() + json.size());
+    const auto result = count_array_elements(context);
+    BOOST_CHECK_EQUAL(context.position, json.data());
+    return result;
+  };
+
+  BOOST_CHECK_EQUAL(count("[]"), 0);
+  BOOST_CHECK_EQUAL(count("[ ]"), 0);
+  BOOST_CHECK_EQUAL(count("[1]"), 1);
+  BOOST_CHECK_EQUAL(count("[ 1 , 2 ]"), 2);
+  BOOST_CHECK_EQUAL(count(R"(["a,b", [1, 2], {"c": [3, 4], "d": ","}, null])"), 4);
+  BOOST_CHECK_EQUAL(count(R"(["\"", "\\", "]"])"), 3);
+  BOOST_CHECK_EQUAL(count("[1,2] trailing"), 2);
+}
+
+BOOST_AUTO_TEST_CASE(json_count_array_elements_unterminated) {
+  const auto count = [](const std::string &json) {
+    const auto context = decode_context(json.data(), json.data() + json.size());
+    return count_array_elements(context);
+  };
+
+  BOOST_CHECK_EQUAL(count(""), 0);
+  BOOST_CHECK_EQUAL(count("{}"), 0);
+  BOOST_CHECK_EQUAL(count("[1,2"), 0);
+  BOOST_CHECK_EQUAL(count("[\"a]"), 0);
+  BOOST_CHECK_EQUAL(count("[\"a\\\"]"), 0);
+  BOOST_CHECK_EQUAL(count("[[1,2]"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_count_object_members) {
+  const auto count = [](const std::string &json) {
+    const auto context = decode_context(json.data(), json.data() + json.size());
+    const auto result = count_object_members(context);
+    BOOST_CHECK_EQUAL(context.position, json.data());
+    return result;
+  };
+
+  BOOST_CHECK_EQUAL(count("{}"), 0);
+  BOOST_CHECK_EQUAL(count("{ }"), 0);
+  BOOST_CHECK_EQUAL(count(R"({"a":1})"), 1);
+  BOOST_CHECK_EQUAL(count(R"({ "a" : [1, 2], "b,c" : {"d": 3, "e": 4} })"), 2);
+  BOOST_CHECK_EQUAL(count(R"({"}": 1, "\"": 2})"), 2);
+  BOOST_CHECK_EQUAL(count("[1,2]"), 0);
+  BOOST_CHECK_EQUAL(count(R"({"a":1)"), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // detail
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/detail/skip_chars.hpp>
+#include <spotify/json/detail/skip_value.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/encode_context.hpp>
+#include <spotify/json/slow_path_counters.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+/**
+ * Check that running the function takes the slow path exactly once, and no
+ * other slow path, when the counters are enabled; and that nothing is counted
+ * when they are not. The scalar fallback is only checked when it is the path
+ * under test, since machines without SSE 4.2 take it everywhere.
+ */
+template <typename function>
+void check_slow_path(const slow_path path, const function &fn) {
+  const auto before = read_slow_path_counters();
+  fn();
+  const auto after = read_slow_path_counters();
+
+  for (size_t i = 0; i < static_cast<size_t>(slow_path::num_slow_paths); i++) {
+    if (slow_path(i) == slow_path::scalar_fallback && path != slow_path::scalar_fallback) {
+      continue;
+    }
+    const auto expected = (slow_path_counters_enabled && i == static_cast<size_t>(path)) ? 1 : 0;
+    BOOST_CHECK_MESSAGE(
+        after.counts[i] - before.counts[i] == uint64_t(expected),
+        slow_path_name(slow_path(i)) << " was counted " << (after.counts[i] - before.counts[i]) << " times");
+  }
+}
+
+struct many_fields_t {
+  int value = 0;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_have_names) {
+  BOOST_CHECK_EQUAL(slow_path_name(slow_path::decode_integer_tricky), std::string("decode_integer_tricky"));
+  BOOST_CHECK_EQUAL(slow_path_name(slow_path::scalar_fallback), std::string("scalar_fallback"));
+}
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_count_decode_integer_tricky) {
+  check_slow_path(slow_path::decode_integer_tricky, [] { BOOST_CHECK_EQUAL(decode<int>("12e1"), 120); });
+}
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_count_decode_escaped_string) {
+  check_slow_path(slow_path::decode_escaped_string, [] { BOOST_CHECK_EQUAL(decode<std::string>(R"("a\n")"), "a\n"); });
+}
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_count_stack_spill) {
+  const auto json = std::string(100, '[') + std::string(100, ']');
+  check_slow_path(slow_path::stack_spill, [&] {
+    auto context = decode_context(json.data(), json.data() + json.size());
+    detail::skip_value(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_count_bitset_spill) {
+  auto codec = codec::object<many_fields_t>();
+  std::string json = "{";
+  for (int i = 0; i < 65; i++) {
+    codec.required("f" + std::to_string(i), &many_fields_t::value);
+    json += (i ? ",\"f" : "\"f") + std::to_string(i) + "\":1";
+  }
+  json += "}";
+  check_slow_path(slow_path::bitset_spill, [&] { decode(codec, json); });
+}
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_count_grow_buffer) {
+  const auto value = std::string(3000, 'a');
+  check_slow_path(slow_path::grow_buffer, [&] {
+    encode_context context;
+    context.append(value.data(), value.size());
+    context.append(value.data(), value.size());
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_count_scalar_fallback) {
+  const auto json = std::string("    1");
+  check_slow_path(slow_path::scalar_fallback, [&] {
+    auto context = decode_context(json.data(), json.data() + json.size());
+    *const_cast<bool *>(&context.has_sse42) = false;
+    detail::skip_any_whitespace(context);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(json_slow_path_counters_should_sum_threads) {
+  const auto before = read_slow_path_counters();
+  std::thread thread([] { decode<int>("1e1"); });
+  thread.join();
+  decode<int>("1e1");
+  const auto after = read_slow_path_counters();
+  const auto counted = after[slow_path::decode_integer_tricky] - before[slow_path::decode_integer_tricky];
+  BOOST_CHECK_EQUAL(counted, slow_path_counters_enabled ? 2 : 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/optional.hpp>
+#include <spotify/json/codec/static_object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct static_track_t {
+  std::string title;
+  int length = 0;
+  bool explicit_lyrics = false;
+};
+
+constexpr auto STATIC_TRACK_CODEC = static_object<static_track_t>(
+    static_required("title", &static_track_t::title),
+    static_optional("length", &static_track_t::length),
+    static_optional("explicit", &static_track_t::explicit_lyrics));
+
+constexpr auto STATIC_KEY = detail::make_static_key("length");
+static_assert(std::string_view(STATIC_KEY.data(), STATIC_KEY.size()) == "\"length\":", "");
+
+struct static_album_t {
+  std::string name;
+  std::vector<int> ratings;
+  std::optional<std::string> label;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode) {
+  const auto track = decode(STATIC_TRACK_CODEC, R"({ "length" : 3, "title":"a", "explicit":true })");
+  BOOST_CHECK_EQUAL(track.title, "a");
+  BOOST_CHECK_EQUAL(track.length, 3);
+  BOOST_CHECK(track.explicit_lyrics);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_escaped_keys) {
+  const auto track = decode(STATIC_TRACK_CODEC, R"({"\u0074itle":"a","len\u0067th":4})");
+  BOOST_CHECK_EQUAL(track.title, "a");
+  BOOST_CHECK_EQUAL(track.length, 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_skip_unknown_fields) {
+  const auto track = decode(STATIC_TRACK_CODEC, R"({"id":{"x":[1,2]},"title":"a","titles":1,"titl":2})");
+  BOOST_CHECK_EQUAL(track.title, "a");
+  BOOST_CHECK_EQUAL(track.length, 0);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_require_required_fields) {
+  BOOST_CHECK_THROW(decode(STATIC_TRACK_CODEC, R"({"length":3})"), decode_exception);
+  BOOST_CHECK_THROW(decode(STATIC_TRACK_CODEC, R"({})"), decode_exception);
+  BOOST_CHECK_THROW(decode(STATIC_TRACK_CODEC, R"({"title":1})"), decode_exception);
+  BOOST_CHECK_THROW(decode(STATIC_TRACK_CODEC, R"([])"), decode_exception);
+  BOOST_CHECK_THROW(decode(STATIC_TRACK_CODEC, R"({"title":"a")"), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_use_the_last_duplicate) {
+  BOOST_CHECK_EQUAL(decode(STATIC_TRACK_CODEC, R"({"title":"a","title":"b"})").title, "b");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_into) {
+  auto track = static_track_t{ "a", 5, true };
+  decode_into(STATIC_TRACK_CODEC, R"({"title":"b","explicit":true})", track);
+  BOOST_CHECK_EQUAL(track.title, "b");
+  BOOST_CHECK_EQUAL(track.length, 0);  // not in the input, so reset
+  BOOST_CHECK(track.explicit_lyrics);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_decode_into_members_with_initializers_like_decode) {
+  struct settings_t {
+    bool enabled = true;
+    int retries = 3;
+    std::string name = "default";
+  };
+  static constexpr auto codec = static_object<settings_t>(
+      static_optional("enabled", &settings_t::enabled),
+      static_optional("retries", &settings_t::retries),
+      static_optional("name", &settings_t::name));
+
+  settings_t settings;
+  decode_into(codec, R"({"enabled":false,"retries":1,"name":"a name"})", settings);
+  BOOST_CHECK(!settings.enabled);
+  decode_into(codec, R"({"retries":2})", settings);
+  BOOST_CHECK(settings.enabled);
+  BOOST_CHECK_EQUAL(settings.retries, 2);
+  BOOST_CHECK_EQUAL(settings.name, "default");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_encode) {
+  BOOST_CHECK_EQUAL(
+      encode(STATIC_TRACK_CODEC, static_track_t{ "a", 3, false }),
+      R"({"title":"a","length":3,"explicit":false})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_support_codecs_that_are_not_literal_types) {
+  const auto codec = static_object<static_album_t>(
+      static_required("name", &static_album_t::name),
+      static_optional("ratings", &static_album_t::ratings),
+      static_optional("label", &static_album_t::label, optional(string())));
+
+  const auto album = decode(codec, R"({"name":"n","ratings":[1,2]})");
+  BOOST_CHECK_EQUAL(album.ratings.size(), 2);
+  BOOST_CHECK(!album.label);
+  BOOST_CHECK_EQUAL(encode(codec, album), R"({"name":"n","ratings":[1,2]})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_static_object_should_reject_names_that_need_escaping) {
+  BOOST_CHECK_THROW(detail::make_static_key("a\"b"), std::invalid_argument);
+  BOOST_CHECK_THROW(detail::make_static_key("a\nb"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
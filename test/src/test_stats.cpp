@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/array.hpp>
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/decode_exception.hpp>
+#include <spotify/json/encode.hpp>
+#include <spotify/json/stats.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+
+namespace {
+
+stats stats_difference(const stats &before, const stats &after) {
+  const auto difference = [](const operation_stats &a, const operation_stats &b) {
+    operation_stats result;
+    result.documents = b.documents - a.documents;
+    result.bytes = b.bytes - a.bytes;
+    result.failures = b.failures - a.failures;
+    for (size_t i = 0; i < latency_histogram::num_buckets; i++) {
+      result.latency.counts[i] = b.latency.counts[i] - a.latency.counts[i];
+    }
+    return result;
+  };
+
+  stats result;
+  result.decode = difference(before.decode, after.decode);
+  result.encode = difference(before.encode, after.encode);
+  return result;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(json_latency_histogram_should_have_exact_buckets_for_small_values) {
+  for (uint64_t i = 0; i < 16; i++) {
+    BOOST_CHECK_EQUAL(latency_histogram::bucket(i), i);
+    BOOST_CHECK_EQUAL(latency_histogram::bucket_lower_bound(i), i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_latency_histogram_should_have_logarithmic_buckets) {
+  BOOST_CHECK_EQUAL(latency_histogram::bucket(16), latency_histogram::bucket(17));
+  BOOST_CHECK_NE(latency_histogram::bucket(17), latency_histogram::bucket(18));
+  BOOST_CHECK_EQUAL(latency_histogram::bucket(1000000), latency_histogram::bucket(1020000));
+  BOOST_CHECK_NE(latency_histogram::bucket(1000000), latency_histogram::bucket(1200000));
+}
+
+BOOST_AUTO_TEST_CASE(json_latency_histogram_should_have_lower_bounds_that_map_to_their_bucket) {
+  for (size_t i = 0; i < latency_histogram::num_buckets; i++) {
+    const auto lower_bound = latency_histogram::bucket_lower_bound(i);
+    BOOST_REQUIRE_EQUAL(latency_histogram::bucket(lower_bound), i);
+    if (i > 0) {
+      BOOST_REQUIRE_EQUAL(latency_histogram::bucket(lower_bound - 1), i - 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_latency_histogram_should_be_accurate_to_an_eighth) {
+  for (uint64_t value = 1; value < (uint64_t(1) << 40); value = value * 3 + 1) {
+    const auto lower_bound = latency_histogram::bucket_lower_bound(latency_histogram::bucket(value));
+    BOOST_REQUIRE_LE(lower_bound, value);
+    BOOST_REQUIRE_LE(value - lower_bound, value / 8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_latency_histogram_should_put_huge_values_in_the_last_bucket) {
+  const auto last = latency_histogram::num_buckets - 1;
+  BOOST_CHECK_EQUAL(latency_histogram::bucket(uint64_t(1) << 40), last);
+  BOOST_CHECK_EQUAL(latency_histogram::bucket(uint64_t(-1)), last);
+}
+
+BOOST_AUTO_TEST_CASE(json_latency_histogram_should_compute_percentiles) {
+  latency_histogram histogram;
+  BOOST_CHECK_EQUAL(histogram.percentile(0.5), 0);
+
+  histogram.counts[latency_histogram::bucket(100)] = 90;
+  histogram.counts[latency_histogram::bucket(5000)] = 10;
+  BOOST_CHECK_EQUAL(histogram.count(), 100);
+  BOOST_CHECK_EQUAL(histogram.percentile(0.5), 96);
+  BOOST_CHECK_EQUAL(histogram.percentile(0.9), 96);
+  BOOST_CHECK_EQUAL(histogram.percentile(0.99), 4608);
+  BOOST_CHECK_EQUAL(histogram.percentile(1), 4608);
+}
+
+BOOST_AUTO_TEST_CASE(json_record_stats_should_aggregate_threads) {
+  const auto before = read_stats();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([] {
+      for (int j = 0; j < 100; j++) {
+        detail::record_stats(detail::stats_operation::decode, 10, false, 1000);
+      }
+      detail::record_stats(detail::stats_operation::encode, 0, true, 2000);
+    });
+  }
+  detail::record_stats(detail::stats_operation::decode, 10, false, 1000);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  const auto stats = stats_difference(before, read_stats());
+  BOOST_CHECK_EQUAL(stats.decode.documents, 401);
+  BOOST_CHECK_EQUAL(stats.decode.bytes, 4010);
+  BOOST_CHECK_EQUAL(stats.decode.failures, 0);
+  BOOST_CHECK_EQUAL(stats.decode.latency.counts[latency_histogram::bucket(1000)], 401);
+  BOOST_CHECK_EQUAL(stats.encode.documents, 0);
+  BOOST_CHECK_EQUAL(stats.encode.failures, 4);
+  BOOST_CHECK_EQUAL(stats.encode.latency.counts[latency_histogram::bucket(2000)], 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_decode_and_encode_should_record_stats_when_enabled) {
+  const auto before = read_stats();
+
+  decode<std::vector<int>>("[1,2,3]");
+  BOOST_CHECK_THROW(decode<std::vector<int>>("[1,2,"), decode_exception);
+  std::vector<int> value;
+  try_decode(value, "");
+  try_decode(value, "[1]");
+  decode_into("[4,5]", value);
+  encode(value);
+
+  const auto stats = stats_difference(before, read_stats());
+  if (stats_enabled) {
+    BOOST_CHECK_EQUAL(stats.decode.documents, 3);
+    BOOST_CHECK_EQUAL(stats.decode.bytes, 7 + 3 + 5);
+    BOOST_CHECK_EQUAL(stats.decode.failures, 2);
+    BOOST_CHECK_EQUAL(stats.decode.latency.count(), 5);
+    BOOST_CHECK_EQUAL(stats.encode.documents, 1);
+    BOOST_CHECK_EQUAL(stats.encode.bytes, 5);
+    BOOST_CHECK_EQUAL(stats.encode.latency.count(), 1);
+  } else {
+    BOOST_CHECK_EQUAL(stats.decode.latency.count(), 0);
+    BOOST_CHECK_EQUAL(stats.encode.latency.count(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify
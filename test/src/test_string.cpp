@@ -20,6 +20,7 @@
 
 #include <spotify/json/codec/map.hpp>
 #include <spotify/json/codec/boolean.hpp>
+#include <spotify/json/codec/object.hpp>
 #include <spotify/json/decode.hpp>
 #include <spotify/json/decode_exception.hpp>
 #include <spotify/json/encode.hpp>
@@ -204,6 +205,20 @@ BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_escaped_string_with_unescap
   BOOST_CHECK_EQUAL(string_parse("\"prefix\\nmiddle\\nsuffix\""), "prefix\nmiddle\nsuffix");
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_into_existing_string) {
+  std::string value;
+  value.reserve(64);
+  const auto data = value.data();
+
+  decode_into(R"("first")", value);
+  BOOST_CHECK_EQUAL(value, "first");
+  decode_into(R"("second\n\u00e5")", value);
+  BOOST_CHECK_EQUAL(value, "second\n\xc3\xa5");
+  decode_into(R"("")", value);
+  BOOST_CHECK_EQUAL(value, "");
+  BOOST_CHECK_EQUAL(static_cast<const void *>(value.data()), static_cast<const void *>(data));
+}
+
 BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_escaped_unicode) {
   // Examples from http://en.wikipedia.org/wiki/UTF-8#Examples
   BOOST_CHECK_EQUAL(string_parse("\"\\u0024\""), "\x24");
@@ -287,6 +302,66 @@ BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_long_escaped_string) {
   BOOST_CHECK_EQUAL(string_parse(string.c_str()), answer);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_long_escaped_string_without_sse42) {
+  const auto string = generate_escaped_string(10027);
+  auto context = decode_context(string.data(), string.size());
+  *const_cast<bool *>(&context.has_sse42) = false;
+  BOOST_CHECK_EQUAL(default_codec<std::string>().decode(context), generate_escaped_string_answer(10027));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_escapes_at_any_position) {
+  for (size_t i = 0; i < 40; i++) {
+    const auto prefix = generate_simple_string_answer(i);
+    const auto json = "\"" + prefix + "\\ud83d\\udc95" + prefix + "\\\"\"";
+    BOOST_CHECK_EQUAL(string_parse(json.c_str()), prefix + "\xf0\x9f\x92\x95" + prefix + "\"");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_report_position_of_invalid_escapes) {
+  const auto error_offset = [](const std::string &json) {
+    auto context = decode_context(json.data(), json.size());
+    try {
+      default_codec<std::string>().decode(context);
+    } catch (const decode_exception &exception) {
+      return exception.offset();
+    }
+    return size_t(0);
+  };
+
+  BOOST_CHECK_EQUAL(error_offset("\"ab\\u0_FF\""), 7);
+  BOOST_CHECK_EQUAL(error_offset("\"ab\\q\""), 4);
+  BOOST_CHECK_EQUAL(error_offset("\"ab\\nc"), 6);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_decode_invalid_utf8_by_default) {
+  BOOST_CHECK_EQUAL(string_parse("\"\xFF\""), "\xFF");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_validate_utf8_when_asked_to) {
+  const auto codec = string();
+  const auto decode_utf8 = [&](const std::string &json) {
+    auto context = decode_context(json.data(), json.size());
+    context.validate_utf8 = true;
+    return codec.decode(context);
+  };
+
+  const auto utf8 = generate_utf8_string(1000);
+  BOOST_CHECK_EQUAL(decode_utf8(utf8), generate_utf8_string_answer(1000));
+  BOOST_CHECK_EQUAL(decode_utf8("\"\xC3\xA9\\n\xE2\x82\xAC\""), "\xC3\xA9\n\xE2\x82\xAC");
+  BOOST_CHECK_THROW(decode_utf8("\"\xFF\""), decode_exception);
+  BOOST_CHECK_THROW(decode_utf8("\"\xC3\""), decode_exception);
+  BOOST_CHECK_THROW(decode_utf8("\"a\\n\xED\xA0\x80\""), decode_exception);
+  BOOST_CHECK_THROW(decode_utf8(utf8.substr(0, 500) + "\x80\""), decode_exception);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_string_should_validate_utf8_when_skipping) {
+  const auto codec = object<std::string>();
+  const std::string json = "{\"a\":[\"\xFF\"]}";
+  auto context = decode_context(json.data(), json.size());
+  context.validate_utf8 = true;
+  BOOST_CHECK_THROW(codec.decode(context), decode_exception);
+}
+
 /*
  * Encoding Simple Strings
  */
@@ -349,6 +424,23 @@ BOOST_AUTO_TEST_CASE(json_codec_string_should_encode_long_string_with_special_ch
   BOOST_CHECK(encode(input_str) == expected_result);
 }
 
+BOOST_AUTO_TEST_CASE(json_codec_string_should_validate_utf8_when_encoding) {
+  const auto codec = string();
+  const auto encode_utf8 = [&](const std::string &value) {
+    encode_context context;
+    context.validate_utf8 = true;
+    codec.encode(context, value);
+    return std::string(context.data(), context.size());
+  };
+
+  // Sequences of three bytes are split by the 1024 byte chunks of encode.
+  BOOST_CHECK_EQUAL(encode_utf8(generate_utf8_string_answer(10027)), generate_utf8_string(10027));
+  BOOST_CHECK_EQUAL(encode(std::string("\xFF")), "\"\xFF\"");
+  BOOST_CHECK_THROW(encode_utf8("\xFF"), encode_exception);
+  BOOST_CHECK_THROW(encode_utf8(generate_utf8_string_answer(500) + "\xE2\x98"), encode_exception);
+  BOOST_CHECK_THROW(encode_utf8(std::string(2000, '\x80')), encode_exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // codec
 BOOST_AUTO_TEST_SUITE_END()  // json
 BOOST_AUTO_TEST_SUITE_END()  // spotify
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019 Spotify AB
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include <string>
+#include <variant>
+
+#include <boost/test/unit_test.hpp>
+
+#include <spotify/json/codec/number.hpp>
+#include <spotify/json/codec/object.hpp>
+#include <spotify/json/codec/static_object.hpp>
+#include <spotify/json/codec/string.hpp>
+#include <spotify/json/codec/transform.hpp>
+#include <spotify/json/codec/variant.hpp>
+#include <spotify/json/decode.hpp>
+#include <spotify/json/encode.hpp>
+
+BOOST_AUTO_TEST_SUITE(spotify)
+BOOST_AUTO_TEST_SUITE(json)
+BOOST_AUTO_TEST_SUITE(codec)
+
+namespace {
+
+struct play_t {
+  std::string uri;
+};
+
+struct seek_t {
+  int position = 0;
+};
+
+struct stop_t {};
+
+using command_t = std::variant<play_t, seek_t, stop_t>;
+
+auto command_codec() {
+  auto play_codec = object<play_t>();
+  play_codec.required("uri", &play_t::uri);
+
+  auto seek_codec = object<seek_t>();
+  seek_codec.required("position", &seek_t::position);
+
+  return variant<command_t>(
+      "type",
+      std::make_pair("play", play_codec),
+      std::make_pair("seek", seek_codec),
+      std::make_pair("stop", object<stop_t>()));
+}
+
+template <typename Codec>
+typename Codec::object_type test_decode(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  auto obj = codec.decode(c);
+  BOOST_CHECK_EQUAL(c.position, c.end);
+  return obj;
+}
+
+template <typename Codec>
+void test_decode_fail(const Codec &codec, const std::string &json) {
+  decode_context c(json.c_str(), json.c_str() + json.size());
+  BOOST_CHECK_THROW(codec.decode(c), decode_exception);
+}
+
+}  // namespace
+
+/*
+ * Decoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_decode_with_discriminator_first) {
+  const auto command = test_decode(command_codec(), R"({"type":"play","uri":"spotify:track:x"})");
+  BOOST_REQUIRE(std::holds_alternative<play_t>(command));
+  BOOST_CHECK_EQUAL(std::get<play_t>(command).uri, "spotify:track:x");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_decode_with_discriminator_last) {
+  const auto command = test_decode(command_codec(), R"({ "position" : 42 , "extra": [1, {}], "type" : "seek" })");
+  BOOST_REQUIRE(std::holds_alternative<seek_t>(command));
+  BOOST_CHECK_EQUAL(std::get<seek_t>(command).position, 42);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_decode_rest_of_object_after_discriminator) {
+  const auto codec = command_codec();
+  const auto command = test_decode(codec, R"({ "type" : "play" , "extra" : [1, {}] , "uri" : "x" })");
+  BOOST_REQUIRE(std::holds_alternative<play_t>(command));
+  BOOST_CHECK_EQUAL(std::get<play_t>(command).uri, "x");
+  test_decode_fail(codec, R"({"type":"play","uri":"x",})");
+  test_decode_fail(codec, R"({"type":"play","uri":"x")");
+  test_decode_fail(codec, R"({"type":"play" "uri":"x"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_not_show_first_discriminator_to_alternatives) {
+  struct captured_t {
+    std::string uri;
+    unknown_fields unknown;
+  };
+  auto captured_codec = object<captured_t>();
+  captured_codec.required("uri", &captured_t::uri);
+  captured_codec.capture_unknown_fields(&captured_t::unknown);
+  const auto codec = variant<std::variant<captured_t>>("type", std::make_pair("a", captured_codec));
+
+  const auto first = std::get<captured_t>(test_decode(codec, R"({"type":"a","uri":"x"})"));
+  BOOST_CHECK_EQUAL(first.uri, "x");
+  BOOST_CHECK(first.unknown.empty());
+
+  const auto last = std::get<captured_t>(test_decode(codec, R"({"uri":"x","type":"a"})"));
+  BOOST_CHECK_EQUAL(last.uri, "x");
+  BOOST_CHECK_EQUAL(last.unknown.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_decode_static_object_alternatives) {
+  static constexpr auto seek_codec = static_object<seek_t>(static_required("position", &seek_t::position));
+  const auto codec = variant<std::variant<seek_t>>("type", std::make_pair("seek", seek_codec));
+  BOOST_CHECK_EQUAL(std::get<seek_t>(test_decode(codec, R"({"type":"seek","position":3})")).position, 3);
+  BOOST_CHECK_EQUAL(std::get<seek_t>(test_decode(codec, R"({"position":4,"type":"seek"})")).position, 4);
+  test_decode_fail(codec, R"({"type":"seek"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_decode_other_alternatives_from_the_start) {
+  auto seek_codec = object<seek_t>();
+  seek_codec.required("position", &seek_t::position);
+  const auto codec = variant<std::variant<seek_t>>(
+      "type",
+      std::make_pair("seek", transform(
+          seek_codec,
+          [](const seek_t &seek) { return seek_t{ seek.position - 1 }; },
+          [](const seek_t &seek) { return seek_t{ seek.position + 1 }; })));
+  BOOST_CHECK_EQUAL(std::get<seek_t>(test_decode(codec, R"({"type":"seek","position":3})")).position, 4);
+  BOOST_CHECK_EQUAL(std::get<seek_t>(test_decode(codec, R"({"position":3,"type":"seek"})")).position, 4);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_decode_escaped_keys_and_tags) {
+  const auto codec = command_codec();
+  const auto first = test_decode(codec, R"({"t\u0079pe":"s\u0065ek","\u0070osition":5})");
+  BOOST_REQUIRE(std::holds_alternative<seek_t>(first));
+  BOOST_CHECK_EQUAL(std::get<seek_t>(first).position, 5);
+  const auto last = test_decode(codec, R"({"\u0070osition":6,"typ\u0065":"seek"})");
+  BOOST_REQUIRE(std::holds_alternative<seek_t>(last));
+  BOOST_CHECK_EQUAL(std::get<seek_t>(last).position, 6);
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_decode_object_with_only_discriminator) {
+  const auto command = test_decode(command_codec(), R"({"type":"stop"})");
+  BOOST_CHECK(std::holds_alternative<stop_t>(command));
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_not_decode_missing_discriminator) {
+  test_decode_fail(command_codec(), R"({})");
+  test_decode_fail(command_codec(), R"({"uri":"spotify:track:x"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_not_decode_unknown_discriminator) {
+  test_decode_fail(command_codec(), R"({"type":"pause"})");
+  test_decode_fail(command_codec(), R"({"type":1})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_not_decode_invalid_alternative) {
+  test_decode_fail(command_codec(), R"({"type":"seek"})");
+  test_decode_fail(command_codec(), R"({"type":"play","uri":1})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_not_decode_non_objects) {
+  test_decode_fail(command_codec(), R"([])");
+  test_decode_fail(command_codec(), R"("play")");
+  test_decode_fail(command_codec(), R"({"type")");
+  test_decode_fail(command_codec(), R"({"position":1,)");
+}
+
+/*
+ * Encoding
+ */
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_encode_discriminator_first) {
+  const auto codec = command_codec();
+  BOOST_CHECK_EQUAL(encode(codec, command_t(play_t{ "x" })), R"({"type":"play","uri":"x"})");
+  BOOST_CHECK_EQUAL(encode(codec, command_t(seek_t{ 7 })), R"({"type":"seek","position":7})");
+  BOOST_CHECK_EQUAL(encode(codec, command_t(stop_t{})), R"({"type":"stop"})");
+}
+
+BOOST_AUTO_TEST_CASE(json_codec_variant_should_encode_and_decode) {
+  const auto codec = command_codec();
+  const auto command = decode(codec, encode(codec, command_t(seek_t{ 123 })));
+  BOOST_REQUIRE(std::holds_alternative<seek_t>(command));
+  BOOST_CHECK_EQUAL(std::get<seek_t>(command).position, 123);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // codec
+BOOST_AUTO_TEST_SUITE_END()  // json
+BOOST_AUTO_TEST_SUITE_END()  // spotify